@@ -22,6 +22,9 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/atomic.h"
+#include "common/config-manager.h"
+#include "common/system.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -40,10 +43,15 @@ namespace Audio {
 
 /**
  * Channel used by the default Mixer implementation.
+ *
+ * A channel is shared between the thread using the Mixer API and the audio
+ * callback. Settings are changed on the API side and published to the
+ * callback through atomic stores; the playback position is published back
+ * by the callback using a sequence counter, so neither side has to lock.
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality);
 	~Channel();
 
 	/**
@@ -87,6 +95,29 @@ public:
 	 */
 	bool isPaused() const { return (_pauseLevel != 0); }
 
+	/**
+	 * Queries whether the channel is paused, as seen by the audio callback.
+	 */
+	bool isPausedForMix() const { return Common::atomicLoad(&_mixPaused) != 0; }
+
+	/**
+	 * Called by the audio callback before it touches the stream. Fails once
+	 * the channel was released, in which case the stream must be left alone.
+	 */
+	bool beginMix() { return Common::atomicCompareAndSwap(&_mixState, kMixStateIdle, kMixStateMixing); }
+
+	/** Called by the audio callback when it is done with the stream. */
+	void endMix() { Common::atomicStore<int32>(&_mixState, kMixStateIdle); }
+
+	/**
+	 * Stop the audio callback from touching the stream from now on. Fails
+	 * while the callback is mixing the channel.
+	 */
+	bool release() {
+		return Common::atomicCompareAndSwap(&_mixState, kMixStateIdle, kMixStateReleased) ||
+		       Common::atomicLoad(&_mixState) == kMixStateReleased;
+	}
+
 	/**
 	 * Sets the channel's own volume.
 	 *
@@ -156,13 +187,41 @@ private:
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
 
+	/** Left (low 16 bits) and right (high 16 bits) volume used by mix(). */
+	uint32 _mixVolume;
+	/** Pause state used by mix(). */
+	int32 _mixPaused;
+
+	enum {
+		kMixStateIdle,
+		kMixStateMixing,
+		kMixStateReleased
+	};
+
+	/** Whether the audio callback is using the stream, or may no longer. */
+	int32 _mixState;
+
 	Mixer *_mixer;
 
+	/**
+	 * Read the playback position published by mix(), retrying while the
+	 * audio callback is in the middle of updating it.
+	 */
+	void readMixState(uint32 &samplesConsumed, uint32 &mixerTimeStamp, uint32 &mixCount) const;
+
+	// Written by mix() only, odd while the fields below are being updated
+	uint32 _mixSequence;
 	uint32 _samplesConsumed;
-	uint32 _samplesDecoded;
 	uint32 _mixerTimeStamp;
+	uint32 _mixCount;
+
+	// Only used by mix()
+	uint32 _samplesDecoded;
+
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
+	/** Value of _mixCount when _pauseTime was measured. */
+	uint32 _pauseMixCount;
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
@@ -173,35 +232,180 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(), _mixBusy(0), _stopsWaiting(0),
+	  _rateConverterQuality(kRateConverterQualityLow) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = 0;
+		_pendingRelease[i] = 0;
+		_mixChannels[i] = 0;
+	}
 }
 
 MixerImpl::~MixerImpl() {
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	// Every channel is either visible to the API or waiting for release,
+	// no matter whether the callback still references it.
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		delete _channels[i];
+		delete _pendingRelease[i];
+	}
+}
+
+void MixerImpl::setRateConverterQuality(RateConverterQuality quality) {
+	Common::StackLock lock(_mutex);
+	_rateConverterQuality = quality;
 }
 
 void MixerImpl::setReady(bool ready) {
+	if (ready)
+		syncSettings();
 	_mixerReady = ready;
 }
 
+void MixerImpl::syncSettings() {
+	RateConverterQuality quality = kRateConverterQualityLow;
+	if (ConfMan.hasKey("resampler_quality")) {
+		const Common::String value = ConfMan.get("resampler_quality");
+		if (value.equalsIgnoreCase("medium"))
+			quality = kRateConverterQualityMedium;
+		else if (value.equalsIgnoreCase("high"))
+			quality = kRateConverterQualityHigh;
+		else if (!value.equalsIgnoreCase("low"))
+			warning("Unknown resampler quality '%s'", value.c_str());
+	}
+
+	setRateConverterQuality(quality);
+}
+
 uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
-			index = i;
+void MixerImpl::pushCommand(ChannelCommand::Type type, int index, Channel *chan) {
+	ChannelCommand cmd;
+	cmd.type = type;
+	cmd.index = index;
+	cmd.channel = chan;
+
+	if (!_commandQueue.push(cmd))
+		error("MixerImpl::pushCommand: command queue overflow");
+}
+
+Channel *MixerImpl::releaseChannel(int index) {
+	Channel *chan = _channels[index];
+	assert(chan && !_pendingRelease[index]);
+
+	_channels[index] = 0;
+	_pendingRelease[index] = chan;
+	pushCommand(ChannelCommand::kRemoveChannel, index, chan);
+	return chan;
+}
+
+void MixerImpl::waitForReleasedChannels(Channel *const *released, int count) {
+	if (!count)
+		return;
+
+	// Callers rely on the stream no longer being used once a stop call
+	// returns, but the callback may be mixing one of the released channels
+	// right now. Wait for each of them to be between two mix() calls. This
+	// never holds up the callback, and the mutex is not held while waiting,
+	// so the stream being mixed may stop other channels.
+	_stopsWaiting++;
+	_mutex.unlock();
+
+	for (int i = 0; i != count; i++) {
+		while (!released[i]->release())
+			g_system->delayMillis(1);
+	}
+
+	_mutex.lock();
+	_stopsWaiting--;
+
+	collectRetiredChannels();
+}
+
+void MixerImpl::collectRetiredChannels() {
+	// Without a running audio callback nobody would drain the command queue,
+	// so stopped channels would never be released. Do the callback's work
+	// here in that case.
+	if (!_mixerReady && Common::atomicCompareAndSwap(&_mixBusy, 0, 1)) {
+		processCommands();
+		Common::atomicStore<int32>(&_mixBusy, 0);
+	}
+
+	// A stop call may still be waiting for a retired channel
+	if (_stopsWaiting)
+		return;
+
+	Channel *chan;
+	while (_retireQueue.pop(chan)) {
+		const int index = chan->getHandle()._val % NUM_CHANNELS;
+		if (_channels[index] == chan)
+			_channels[index] = 0;
+		else if (_pendingRelease[index] == chan)
+			_pendingRelease[index] = 0;
+		else
+			warning("MixerImpl::collectRetiredChannels: unknown channel retired");
+
+		delete chan;
+	}
+}
+
+void MixerImpl::processCommands() {
+	ChannelCommand cmd;
+	while (_commandQueue.pop(cmd)) {
+		switch (cmd.type) {
+		case ChannelCommand::kAddChannel:
+			assert(!_mixChannels[cmd.index]);
+			_mixChannels[cmd.index] = cmd.channel;
 			break;
+
+		case ChannelCommand::kRemoveChannel:
+			// The channel may have finished and been retired already
+			if (_mixChannels[cmd.index] == cmd.channel)
+				retireChannel(cmd.index);
+			break;
+		}
+	}
+}
+
+void MixerImpl::retireChannel(int index) {
+	Channel *chan = _mixChannels[index];
+	_mixChannels[index] = 0;
+
+	if (!_retireQueue.push(chan))
+		error("MixerImpl::retireChannel: retire queue overflow");
+}
+
+int MixerImpl::findFreeSlot() {
+	// Stopped channels keep their slot until the callback retired them.
+	// When sounds are started and stopped faster than the callback runs,
+	// give it a chance to catch up instead of failing right away. The
+	// wait is bounded, since this may be called by a stream being mixed.
+	for (int tries = 0; ; tries++) {
+		collectRetiredChannels();
+
+		bool pending = false;
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] == 0 && _pendingRelease[i] == 0)
+				return i;
+			if (_pendingRelease[i])
+				pending = true;
 		}
+
+		if (!pending || tries == kMaxSlotWaitMillis)
+			return -1;
+
+		_mutex.unlock();
+		g_system->delayMillis(1);
+		_mutex.lock();
 	}
+}
+
+void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+	const int index = findFreeSlot();
 	if (index == -1) {
 		warning("MixerImpl::out of mixer slots");
 		delete chan;
@@ -217,6 +421,8 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	pushCommand(ChannelCommand::kAddChannel, index, chan);
 }
 
 void MixerImpl::playStream(
@@ -237,6 +443,8 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+	collectRetiredChannels();
+
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
@@ -258,7 +466,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _rateConverterQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -267,71 +475,96 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
-
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
 	len >>= 2;
 
+	//  zero the buf
+	memset(buf, 0, 2 * len * sizeof(int16));
+
+	// A game thread only applies the commands in our place until the mixer
+	// is ready, which takes a few instructions. Wait for it to finish rather
+	// than skipping this pass.
+	while (!Common::atomicCompareAndSwap(&_mixBusy, 0, 1))
+		;
+
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
-	//  zero the buf
-	memset(buf, 0, 2 * len * sizeof(int16));
+	processCommands();
 
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
-			}
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		Channel *chan = _mixChannels[i];
+
+		// Released channels are retired by their remove command
+		if (!chan || !chan->beginMix())
+			continue;
+
+		if (chan->isFinished()) {
+			chan->endMix();
+			retireChannel(i);
+			continue;
+		}
+
+		if (!chan->isPausedForMix()) {
+			tmp = chan->mix(buf, len);
+
+			if (tmp > res)
+				res = tmp;
 		}
 
+		chan->endMix();
+	}
+
+	Common::atomicStore<int32>(&_mixBusy, 0);
+
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
+	Channel *released[NUM_CHANNELS];
+	int count = 0;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_channels[i] != 0 && !_channels[i]->isPermanent())
+			released[count++] = releaseChannel(i);
 	}
+	waitForReleasedChannels(released, count);
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
+	Channel *released[NUM_CHANNELS];
+	int count = 0;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_channels[i] != 0 && _channels[i]->getId() == id)
+			released[count++] = releaseChannel(i);
 	}
+	waitForReleasedChannels(released, count);
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	Channel *released = releaseChannel(index);
+	waitForReleasedChannels(&released, 1);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].mute = mute;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
@@ -387,6 +620,7 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -397,6 +631,7 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0) {
 			_channels[i]->pause(paused);
@@ -406,6 +641,7 @@ void MixerImpl::pauseAll(bool paused) {
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
 			_channels[i]->pause(paused);
@@ -432,6 +668,8 @@ bool MixerImpl::isSoundIDActive(int id) {
 	g_eventRec.updateSubsystems();
 #endif
 
+	collectRetiredChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getId() == id)
 			return true;
@@ -440,6 +678,7 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
 	const int index = handle._val % NUM_CHANNELS;
 	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
 		return _channels[index]->getId();
@@ -453,12 +692,15 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
+	collectRetiredChannels();
+
 	const int index = handle._val % NUM_CHANNELS;
 	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
+	collectRetiredChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
@@ -495,16 +737,17 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent,
+                 RateConverterQuality quality)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
-      _stream(stream, autofreeStream) {
+      _balance(0), _pauseLevel(0), _mixSequence(0), _samplesConsumed(0), _mixerTimeStamp(0), _mixCount(0),
+      _samplesDecoded(0), _pauseStartTime(0), _pauseTime(0), _pauseMixCount(0), _converter(0), _volL(0), _volR(0),
+      _mixVolume(0), _mixPaused(0), _mixState(kMixStateIdle), _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -554,6 +797,8 @@ void Channel::updateChannelVolumes() {
 	} else {
 		_volL = _volR = 0;
 	}
+
+	Common::atomicStore<uint32>(&_mixVolume, _volL | ((uint32)_volR << 16));
 }
 
 void Channel::pause(bool paused) {
@@ -562,35 +807,57 @@ void Channel::pause(bool paused) {
 	if (paused) {
 		_pauseLevel++;
 
-		if (_pauseLevel == 1)
+		if (_pauseLevel == 1) {
 			_pauseStartTime = g_system->getMillis(true);
+			Common::atomicStore<int32>(&_mixPaused, 1);
+		}
 	} else if (_pauseLevel > 0) {
 		_pauseLevel--;
 
 		if (!_pauseLevel) {
+			uint32 samplesConsumed, mixerTimeStamp;
+			readMixState(samplesConsumed, mixerTimeStamp, _pauseMixCount);
+
 			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
 			_pauseStartTime = 0;
+			Common::atomicStore<int32>(&_mixPaused, 0);
 		}
 	}
 }
 
+void Channel::readMixState(uint32 &samplesConsumed, uint32 &mixerTimeStamp, uint32 &mixCount) const {
+	uint32 sequence;
+	do {
+		sequence = Common::atomicLoad(&_mixSequence);
+		samplesConsumed = Common::atomicLoad(&_samplesConsumed);
+		mixerTimeStamp = Common::atomicLoad(&_mixerTimeStamp);
+		mixCount = Common::atomicLoad(&_mixCount);
+	} while ((sequence & 1) || sequence != Common::atomicLoad(&_mixSequence));
+}
+
 Timestamp Channel::getElapsedTime() {
 	const uint32 rate = _mixer->getOutputRate();
 	uint32 delta = 0;
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	uint32 samplesConsumed, mixerTimeStamp, mixCount;
+	readMixState(samplesConsumed, mixerTimeStamp, mixCount);
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
 	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+		delta = _pauseStartTime - mixerTimeStamp;
+	else if (mixCount == _pauseMixCount)
+		// The channel has not been mixed since it was unpaused
+		delta = g_system->getMillis(true) - mixerTimeStamp - _pauseTime;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - mixerTimeStamp;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -610,10 +877,16 @@ int Channel::mix(int16 *data, uint len) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
-		_samplesConsumed = _samplesDecoded;
-		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+
+		const uint32 sequence = _mixSequence;
+		Common::atomicStore(&_mixSequence, sequence + 1);
+		Common::atomicStore(&_samplesConsumed, _samplesDecoded);
+		Common::atomicStore(&_mixerTimeStamp, g_system->getMillis(true));
+		Common::atomicStore(&_mixCount, _mixCount + 1);
+		Common::atomicStore(&_mixSequence, sequence + 2);
+
+		const uint32 volume = Common::atomicLoad(&_mixVolume);
+		res = _converter->flow(*_stream, data, len, volume & 0xFFFF, volume >> 16);
 		_samplesDecoded += res;
 	}
 
@@ -277,6 +277,13 @@ public:
 	 * @return the output sample rate in Hz
 	 */
 	virtual uint getOutputRate() const = 0;
+
+	/**
+	 * Re-read the mixer settings, like "resampler_quality", from the
+	 * config manager. Only affects sounds started afterwards. Mixers
+	 * without such settings need not implement this.
+	 */
+	virtual void syncSettings() {}
 };
 
 
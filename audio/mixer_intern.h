@@ -25,7 +25,9 @@
 
 #include "common/scummsys.h"
 #include "common/mutex.h"
+#include "common/lockfree-queue.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -42,6 +44,14 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * The mixer callback never takes the mixer mutex. The mutex only serializes
+ * the public API between game threads; channels are handed to and taken
+ * from the callback through lock-free queues, and per channel settings like
+ * volume and pause state are published with atomic stores. This way a game
+ * thread holding the mutex for a long time cannot stall audio output.
+ * Stop calls wait until the callback is done with the streams of the
+ * stopped channels, so callers may free them afterwards.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -51,7 +61,9 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		/** How long to wait for stopped channels to free their slot. */
+		kMaxSlotWaitMillis = 100
 	};
 
 	Common::Mutex _mutex;
@@ -68,8 +80,66 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/**
+	 * Channels as seen by the public API, guarded by _mutex. A channel
+	 * stays here until it is stopped or the callback reports it finished.
+	 */
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * Stopped channels the callback may still be mixing, guarded by _mutex.
+	 * Their slots cannot be reused until the callback retires them.
+	 */
+	Channel *_pendingRelease[NUM_CHANNELS];
+
+	/**
+	 * Channels currently mixed by the callback. Only accessed by whoever
+	 * holds _mixBusy, which normally is the audio callback.
+	 */
+	Channel *_mixChannels[NUM_CHANNELS];
+
+	struct ChannelCommand {
+		enum Type {
+			kAddChannel,
+			kRemoveChannel
+		};
+
+		Type type;
+		int index;
+		Channel *channel;
+	};
+
+	/**
+	 * Every slot can have at most one add and one remove command in flight,
+	 * and at most one retired channel waiting to be deleted, so these never
+	 * overflow.
+	 */
+	enum {
+		QUEUE_SIZE = 4 * NUM_CHANNELS
+	};
+
+	/** Channel commands, pushed under _mutex and drained by the callback. */
+	Common::LockFreeQueue<ChannelCommand, QUEUE_SIZE> _commandQueue;
+
+	/** Channels the callback no longer mixes, to be deleted under _mutex. */
+	Common::LockFreeQueue<Channel *, QUEUE_SIZE> _retireQueue;
+
+	/**
+	 * Non-zero while the command queue is drained and channels are mixed.
+	 * Only contended before the mixer is ready, when game threads drain the
+	 * command queue themselves.
+	 */
+	int32 _mixBusy;
+
+	/**
+	 * Number of stop calls waiting for the callback to let go of released
+	 * channels, guarded by _mutex. No channels are deleted meanwhile.
+	 */
+	int _stopsWaiting;
+
+	RateConverterQuality _rateConverterQuality;
+
 
 public:
 
@@ -118,9 +188,49 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	virtual void syncSettings();
+
 protected:
+	/** Must be called with _mutex held. */
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	/**
+	 * Remove a channel from the API view and ask the callback to drop it.
+	 * Returns the released channel.
+	 */
+	Channel *releaseChannel(int index);
+
+	/**
+	 * Wait until the callback no longer uses the streams of the given
+	 * released channels, then delete the retired channels. Must be called
+	 * with _mutex held, which is released while waiting. Must not be called
+	 * by a stream for its own channel from within mix().
+	 */
+	void waitForReleasedChannels(Channel *const *released, int count);
+
+	/** Queue a command for the callback. Must be called with _mutex held. */
+	void pushCommand(ChannelCommand::Type type, int index, Channel *chan);
+
+	/**
+	 * Delete all channels the callback has retired. Must be called with
+	 * _mutex held, which all public methods touching channels do first.
+	 */
+	void collectRetiredChannels();
+
+	/**
+	 * Find an unused slot, waiting a bit for stopped channels to be retired
+	 * if there is none. Returns -1 if all slots stay in use. Must be called
+	 * with _mutex held, which is released while waiting.
+	 */
+	int findFreeSlot();
+
+	/** Apply all queued commands. Must be called with _mixBusy set. */
+	void processCommands();
+
+	/** Hand a channel back to the API side for deletion. */
+	void retireChannel(int index);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -133,10 +243,19 @@ public:
 	 */
 	int mixCallback(byte *samples, uint len);
 
+	/**
+	 * Set the rate conversion quality for sounds started from now on.
+	 * syncSettings() sets it from the "resampler_quality" config key, so
+	 * backends only need this to choose a quality for a specific output
+	 * device after the mixer is ready.
+	 */
+	void setRateConverterQuality(RateConverterQuality quality);
+
 	/**
 	 * Set the internal 'is ready' flag of the mixer.
 	 * Backends should invoke Mixer::setReady(true) once initialisation of
-	 * their audio system has been completed.
+	 * their audio system has been completed. This also applies the current
+	 * mixer settings via syncSettings().
 	 */
 	void setReady(bool ready);
 };
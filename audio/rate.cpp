@@ -31,10 +31,21 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
 #include "common/frac.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#include <math.h>
+
+#if !defined(OUTPUT_UNSIGNED_AUDIO) && defined(__SSE2__)
+#define USE_SSE2_RATE_MIXER
+#include <emmintrin.h>
+#elif !defined(OUTPUT_UNSIGNED_AUDIO) && defined(__ARM_NEON)
+#define USE_NEON_RATE_MIXER
+#include <arm_neon.h>
+#endif
+
 namespace Audio {
 
 
@@ -57,6 +68,253 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+#pragma mark -
+
+
+/**
+ * Mix interleaved stereo frames into the output buffer. This is the scalar
+ * reference implementation; the vectorized variants below must produce
+ * exactly the same results.
+ */
+template<bool reverseStereo>
+static void mixStereoFramesScalar(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; frames > 0; --frames) {
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (ibuf[0] * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (ibuf[1] * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		ibuf += 2;
+		obuf += 2;
+	}
+}
+
+/**
+ * Mix mono samples into both channels of the output buffer.
+ */
+static void mixMonoFramesScalar(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; frames > 0; --frames) {
+		clampedAdd(obuf[0], (*ibuf * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (*ibuf * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		ibuf++;
+		obuf += 2;
+	}
+}
+
+#if defined(USE_SSE2_RATE_MIXER)
+
+/**
+ * Scale four frames of interleaved stereo samples by the volume vector and
+ * add them to four output frames with saturation.
+ *
+ * The division by kMaxMixerVolume has to round towards zero like the scalar
+ * code does, so negative products get a bias of 255 before the shift.
+ */
+static inline __m128i mixFourFramesSSE2(__m128i out, __m128i in, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i prod0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i prod1 = _mm_unpackhi_epi16(lo, hi);
+
+	const __m128i bias = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+	prod0 = _mm_add_epi32(prod0, _mm_and_si128(_mm_srai_epi32(prod0, 31), bias));
+	prod1 = _mm_add_epi32(prod1, _mm_and_si128(_mm_srai_epi32(prod1, 31), bias));
+	prod0 = _mm_srai_epi32(prod0, 8);
+	prod1 = _mm_srai_epi32(prod1, 8);
+
+	return _mm_adds_epi16(out, _mm_packs_epi32(prod0, prod1));
+}
+
+template<bool reverseStereo>
+static st_size_t mixStereoFramesSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = reverseStereo ? _mm_set_epi16(vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r)
+	                                  : _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+	const st_size_t blocks = frames / 4;
+
+	for (st_size_t i = 0; i < blocks; ++i) {
+		__m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+		if (reverseStereo) {
+			in = _mm_shufflelo_epi16(in, _MM_SHUFFLE(2, 3, 0, 1));
+			in = _mm_shufflehi_epi16(in, _MM_SHUFFLE(2, 3, 0, 1));
+		}
+
+		const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		_mm_storeu_si128((__m128i *)obuf, mixFourFramesSSE2(out, in, vol));
+
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	return blocks * 4;
+}
+
+static st_size_t mixMonoFramesSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+	const st_size_t blocks = frames / 8;
+
+	for (st_size_t i = 0; i < blocks; ++i) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+
+		__m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		_mm_storeu_si128((__m128i *)obuf, mixFourFramesSSE2(out, _mm_unpacklo_epi16(in, in), vol));
+
+		out = _mm_loadu_si128((const __m128i *)(obuf + 8));
+		_mm_storeu_si128((__m128i *)(obuf + 8), mixFourFramesSSE2(out, _mm_unpackhi_epi16(in, in), vol));
+
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	return blocks * 8;
+}
+
+#elif defined(USE_NEON_RATE_MIXER)
+
+/**
+ * Scale four frames of interleaved stereo samples by the volume vector and
+ * add them to four output frames with saturation.
+ *
+ * The division by kMaxMixerVolume has to round towards zero like the scalar
+ * code does, so negative products get a bias of 255 before the shift.
+ */
+static inline int16x8_t mixFourFramesNEON(int16x8_t out, int16x8_t in, int16x8_t vol) {
+	int32x4_t prod0 = vmull_s16(vget_low_s16(in), vget_low_s16(vol));
+	int32x4_t prod1 = vmull_s16(vget_high_s16(in), vget_high_s16(vol));
+
+	prod0 = vaddq_s32(prod0, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(prod0, 31)), 24)));
+	prod1 = vaddq_s32(prod1, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(prod1, 31)), 24)));
+
+	return vqaddq_s16(out, vcombine_s16(vshrn_n_s32(prod0, 8), vshrn_n_s32(prod1, 8)));
+}
+
+static inline int16x8_t makeVolumeNEON(st_volume_t vol_l, st_volume_t vol_r) {
+	const int16x4_t l = vdup_n_s16(vol_l);
+	const int16x4_t r = vdup_n_s16(vol_r);
+	const int16x4x2_t lr = vzip_s16(l, r);
+	return vcombine_s16(lr.val[0], lr.val[1]);
+}
+
+template<bool reverseStereo>
+static st_size_t mixStereoFramesSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16x8_t vol = reverseStereo ? makeVolumeNEON(vol_r, vol_l) : makeVolumeNEON(vol_l, vol_r);
+	const st_size_t blocks = frames / 4;
+
+	for (st_size_t i = 0; i < blocks; ++i) {
+		int16x8_t in = vld1q_s16(ibuf);
+		if (reverseStereo)
+			in = vrev32q_s16(in);
+
+		vst1q_s16(obuf, mixFourFramesNEON(vld1q_s16(obuf), in, vol));
+
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	return blocks * 4;
+}
+
+static st_size_t mixMonoFramesSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16x8_t vol = makeVolumeNEON(vol_l, vol_r);
+	const st_size_t blocks = frames / 8;
+
+	for (st_size_t i = 0; i < blocks; ++i) {
+		const int16x8x2_t in = vzipq_s16(vld1q_s16(ibuf), vld1q_s16(ibuf));
+
+		vst1q_s16(obuf, mixFourFramesNEON(vld1q_s16(obuf), in.val[0], vol));
+		vst1q_s16(obuf + 8, mixFourFramesNEON(vld1q_s16(obuf + 8), in.val[1], vol));
+
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	return blocks * 8;
+}
+
+#endif
+
+/**
+ * Mix a block of converted frames into the output buffer, applying the
+ * channel volumes and clamping the result.
+ *
+ * @param obuf   output buffer of interleaved stereo samples
+ * @param ibuf   input samples, interleaved if stereo
+ * @param frames number of frames (sample pairs for stereo input)
+ * @param vol_l  volume of the left output channel
+ * @param vol_r  volume of the right output channel
+ */
+template<bool stereo, bool reverseStereo>
+static void mixFrames(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+#if defined(USE_SSE2_RATE_MIXER) || defined(USE_NEON_RATE_MIXER)
+	// The vector code relies on the scaled samples fitting into 16 bits,
+	// which is only guaranteed for volumes up to kMaxMixerVolume.
+	if (vol_l <= Audio::Mixer::kMaxMixerVolume && vol_r <= Audio::Mixer::kMaxMixerVolume) {
+		const st_size_t done = stereo ? mixStereoFramesSIMD<reverseStereo>(obuf, ibuf, frames, vol_l, vol_r)
+		                              : mixMonoFramesSIMD(obuf, ibuf, frames, vol_l, vol_r);
+		obuf += done * 2;
+		ibuf += done * (stereo ? 2 : 1);
+		frames -= done;
+	}
+#endif
+
+	if (stereo)
+		mixStereoFramesScalar<reverseStereo>(obuf, ibuf, frames, vol_l, vol_r);
+	else
+		mixMonoFramesScalar(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+
+#pragma mark -
+
+
+/**
+ * Base class for rate converters which first convert the input into an
+ * intermediate buffer, which is then mixed into the output in one go.
+ */
+template<bool stereo, bool reverseStereo>
+class BufferedRateConverter : public RateConverter {
+protected:
+	/** converted samples, waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/**
+	 * Convert up to 'frames' frames from the input into outBuf.
+	 * Return number of frames converted, which is less than requested only
+	 * if the input ran out of data.
+	 */
+	virtual int convert(AudioStream &input, st_size_t frames) = 0;
+
+public:
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+int BufferedRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	const st_size_t maxFrames = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+	st_size_t done = 0;
+
+	while (done < osamp) {
+		const st_size_t frames = MIN(osamp - done, maxFrames);
+		const st_size_t converted = convert(input, frames);
+
+		mixFrames<stereo, reverseStereo>(obuf + done * 2, outBuf, converted, vol_l, vol_r);
+		done += converted;
+
+		if (converted < frames)
+			break;
+	}
+	return done;
+}
+
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -64,8 +322,10 @@ enum {
  * Limited to sampling frequency <= 65535 Hz.
  */
 template<bool stereo, bool reverseStereo>
-class SimpleRateConverter : public RateConverter {
+class SimpleRateConverter : public BufferedRateConverter<stereo, reverseStereo> {
 protected:
+	using BufferedRateConverter<stereo, reverseStereo>::outBuf;
+
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
@@ -79,10 +339,7 @@ protected:
 
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
-	}
+	int convert(AudioStream &input, st_size_t frames);
 };
 
 
@@ -108,15 +365,15 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
 }
 
 /*
- * Processed signed long samples from ibuf to obuf.
- * Return number of sample pairs processed.
+ * Resample up to 'frames' frames from the input into outBuf.
+ * Return number of frames converted.
  */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
+int SimpleRateConverter<stereo, reverseStereo>::convert(AudioStream &input, st_size_t frames) {
+	st_sample_t *obuf, *oend;
 
-	ostart = obuf;
-	oend = obuf + osamp * 2;
+	obuf = outBuf;
+	oend = outBuf + frames * (stereo ? 2 : 1);
 
 	while (obuf < oend) {
 
@@ -127,7 +384,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
 				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+					return (obuf - outBuf) / (stereo ? 2 : 1);
 			}
 			inLen -= (stereo ? 2 : 1);
 			opos--;
@@ -136,22 +393,14 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 			}
 		} while (opos >= 0);
 
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
+		*obuf++ = *inPtr++;
+		if (stereo)
+			*obuf++ = *inPtr++;
 
 		// Increment output position
 		opos += opos_inc;
-
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-		obuf += 2;
 	}
-	return (obuf - ostart) / 2;
+	return (obuf - outBuf) / (stereo ? 2 : 1);
 }
 
 /**
@@ -166,8 +415,10 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  */
 
 template<bool stereo, bool reverseStereo>
-class LinearRateConverter : public RateConverter {
+class LinearRateConverter : public BufferedRateConverter<stereo, reverseStereo> {
 protected:
+	using BufferedRateConverter<stereo, reverseStereo>::outBuf;
+
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
@@ -185,10 +436,7 @@ protected:
 
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
-	}
+	int convert(AudioStream &input, st_size_t frames);
 };
 
 
@@ -217,15 +465,15 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
 }
 
 /*
- * Processed signed long samples from ibuf to obuf.
- * Return number of sample pairs processed.
+ * Interpolate up to 'frames' frames from the input into outBuf.
+ * Return number of frames converted.
  */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
+int LinearRateConverter<stereo, reverseStereo>::convert(AudioStream &input, st_size_t frames) {
+	st_sample_t *obuf, *oend;
 
-	ostart = obuf;
-	oend = obuf + osamp * 2;
+	obuf = outBuf;
+	oend = outBuf + frames * (stereo ? 2 : 1);
 
 	while (obuf < oend) {
 
@@ -236,7 +484,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
 				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+					return (obuf - outBuf) / (stereo ? 2 : 1);
 			}
 			inLen -= (stereo ? 2 : 1);
 			ilast0 = icur0;
@@ -252,25 +500,299 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		// still space in the output buffer.
 		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
 			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
+			*obuf++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+			if (stereo)
+				*obuf++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+
+			// Increment output position
+			opos += opos_inc;
+		}
+	}
+	return (obuf - outBuf) / (stereo ? 2 : 1);
+}
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+#pragma mark -
 
-			obuf += 2;
 
-			// Increment output position
-			opos += opos_inc;
+/**
+ * Settings of the windowed sinc filters used for the different quality
+ * levels. More taps give a steeper transition band, at the cost of CPU time.
+ */
+struct SincFilterSettings {
+	int taps;          ///< filter length, has to be a multiple of 8
+	double passband;   ///< cutoff frequency, relative to the Nyquist frequency
+	double kaiserBeta; ///< shape parameter of the Kaiser window
+};
+
+static const SincFilterSettings sincFilterSettings[] = {
+	{ 16, 0.85, 7.0 }, // kRateConverterQualityMedium
+	{ 32, 0.92, 9.0 }  // kRateConverterQualityHigh
+};
+
+enum {
+	/** Maximal number of filter phases; conversions needing more share phases. */
+	SINC_MAX_PHASES = 256,
+	/** Fixed point precision of the filter coefficients. */
+	SINC_COEF_BITS = 14,
+	/** Size of the per channel input history, in frames. */
+	SINC_HISTORY_SIZE = 1024
+};
+
+/**
+ * Coefficient table of a polyphase windowed sinc filter.
+ *
+ * The tables only depend on the rates and the quality, so converters for
+ * the same conversion share them. They are kept in a list while in use and
+ * freed once the last converter using them is gone.
+ */
+struct SincFilterTable {
+	st_rate_t inrate, outrate;
+	RateConverterQuality quality;
+	int taps;
+	uint phases;
+	int16 *coefs; ///< 'phases' consecutive sets of 'taps' coefficients
+
+	int refCount;
+	SincFilterTable *next;
+};
+
+static SincFilterTable *sincFilterTables = nullptr;
+
+/** Zeroth order modified Bessel function of the first kind. */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+static void computeSincFilter(SincFilterTable *table) {
+	const SincFilterSettings &settings = sincFilterSettings[table->quality - kRateConverterQualityMedium];
+	const int taps = table->taps;
+	const int center = taps / 2 - 1;
+
+	// Cutoff relative to the input sample rate, which has to stay below the
+	// Nyquist frequency of the output when downsampling.
+	double cutoff = 0.5 * settings.passband;
+	if (table->outrate < table->inrate)
+		cutoff = cutoff * table->outrate / table->inrate;
+
+	const double i0Beta = besselI0(settings.kaiserBeta);
+	double *window = new double[taps];
+
+	for (uint phase = 0; phase < table->phases; ++phase) {
+		const double offset = (double)phase / table->phases;
+		double sum = 0.0;
+
+		for (int k = 0; k < taps; ++k) {
+			const double x = k - center - offset;
+			const double u = x / (taps / 2);
+			const double kaiser = (u >= 1.0 || u <= -1.0) ? 0.0 : besselI0(settings.kaiserBeta * sqrt(1.0 - u * u)) / i0Beta;
+			const double sinc = (x == 0.0) ? 1.0 : sin(2 * M_PI * cutoff * x) / (2 * M_PI * cutoff * x);
+
+			window[k] = sinc * kaiser;
+			sum += window[k];
+		}
+
+		// Normalize every phase to unity gain, and put the rounding error
+		// into the center tap so DC passes through unchanged.
+		int16 *coefs = table->coefs + phase * taps;
+		int total = 0;
+		for (int k = 0; k < taps; ++k) {
+			coefs[k] = (int16)floor(window[k] / sum * (1 << SINC_COEF_BITS) + 0.5);
+			total += coefs[k];
+		}
+		coefs[center + (offset >= 0.5 ? 1 : 0)] += (1 << SINC_COEF_BITS) - total;
+	}
+
+	delete[] window;
+}
+
+static SincFilterTable *acquireSincFilter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality) {
+	for (SincFilterTable *table = sincFilterTables; table; table = table->next) {
+		if (table->inrate == inrate && table->outrate == outrate && table->quality == quality) {
+			table->refCount++;
+			return table;
+		}
+	}
+
+	SincFilterTable *table = new SincFilterTable;
+	table->inrate = inrate;
+	table->outrate = outrate;
+	table->quality = quality;
+	table->taps = sincFilterSettings[quality - kRateConverterQualityMedium].taps;
+	table->phases = MIN<uint>(outrate / Common::gcd(inrate, outrate), SINC_MAX_PHASES);
+	table->coefs = new int16[table->phases * table->taps];
+	table->refCount = 1;
+	computeSincFilter(table);
+
+	table->next = sincFilterTables;
+	sincFilterTables = table;
+	return table;
+}
+
+static void releaseSincFilter(SincFilterTable *table) {
+	if (--table->refCount > 0)
+		return;
+
+	for (SincFilterTable **link = &sincFilterTables; *link; link = &(*link)->next) {
+		if (*link == table) {
+			*link = table->next;
+			break;
 		}
 	}
-	return (obuf - ostart) / 2;
+
+	delete[] table->coefs;
+	delete table;
+}
+
+/**
+ * Apply one phase of the filter to the input history, returning the result
+ * with SINC_COEF_BITS fractional bits. The coefficients are normalized, so
+ * the sum always fits into 32 bits.
+ */
+static inline int32 sincDotProduct(const st_sample_t *samples, const int16 *coefs, int taps) {
+#if defined(USE_SSE2_RATE_MIXER)
+	__m128i acc = _mm_setzero_si128();
+	for (int k = 0; k < taps; k += 8)
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(samples + k)), _mm_loadu_si128((const __m128i *)(coefs + k))));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(acc);
+#elif defined(USE_NEON_RATE_MIXER)
+	int32x4_t acc = vdupq_n_s32(0);
+	for (int k = 0; k < taps; k += 8) {
+		const int16x8_t s = vld1q_s16(samples + k);
+		const int16x8_t c = vld1q_s16(coefs + k);
+		acc = vmlal_s16(acc, vget_low_s16(s), vget_low_s16(c));
+		acc = vmlal_s16(acc, vget_high_s16(s), vget_high_s16(c));
+	}
+	const int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	return vget_lane_s32(vpadd_s32(sum, sum), 0);
+#else
+	int32 acc = 0;
+	for (int k = 0; k < taps; ++k)
+		acc += samples[k] * coefs[k];
+	return acc;
+#endif
+}
+
+/**
+ * Audio rate converter based on a band-limited polyphase filter.
+ *
+ * For a conversion from inrate to outrate, which reduced by their greatest
+ * common divisor are M:L, every output sample lies at one of L fractional
+ * positions between two input samples. The filter coefficients for each of
+ * these phases are computed once (see SincFilterTable), so converting one
+ * sample costs a single dot product per channel. If L is too big, nearby
+ * positions share the coefficients of a common phase.
+ *
+ * The input is kept deinterleaved, so the dot products operate on
+ * contiguous samples.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public BufferedRateConverter<stereo, reverseStereo> {
+protected:
+	using BufferedRateConverter<stereo, reverseStereo>::outBuf;
+
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** input history, one row per channel */
+	st_sample_t history[stereo ? 2 : 1][SINC_HISTORY_SIZE];
+	/** first frame of the history the next output frame is computed from */
+	uint32 histPos;
+	/** number of valid frames in the history */
+	uint32 histLen;
+
+	/** position between histPos and histPos + 1, in units of 1 / phaseCount */
+	uint32 phase;
+	/** phase increment per output frame */
+	uint32 phaseInc;
+	/** number of positions between two input frames */
+	uint32 phaseCount;
+
+	SincFilterTable *filter;
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality);
+	~SincRateConverter();
+	int convert(AudioStream &input, st_size_t frames);
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality) {
+	const st_rate_t div = Common::gcd(inrate, outrate);
+
+	filter = acquireSincFilter(inrate, outrate, quality);
+	phase = 0;
+	phaseInc = inrate / div;
+	phaseCount = outrate / div;
+
+	if (phaseInc / phaseCount + filter->taps >= SINC_HISTORY_SIZE) {
+		error("rate effect can only handle rate ratios up to %d", SINC_HISTORY_SIZE - filter->taps);
+	}
+
+	// Prime the history with silence, so the first input frame is in the
+	// center of the filter.
+	memset(history, 0, sizeof(history));
+	histPos = 0;
+	histLen = filter->taps / 2 - 1;
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	releaseSincFilter(filter);
+}
+
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::convert(AudioStream &input, st_size_t frames) {
+	const int taps = filter->taps;
+	st_sample_t *obuf = outBuf;
+
+	for (st_size_t i = 0; i < frames; ++i) {
+		// Make sure the whole filter window is available
+		while (histPos + taps > histLen) {
+			if (histPos >= histLen) {
+				histPos -= histLen;
+				histLen = 0;
+			} else if (histPos > 0) {
+				for (int ch = 0; ch < (stereo ? 2 : 1); ++ch)
+					memmove(history[ch], history[ch] + histPos, (histLen - histPos) * sizeof(st_sample_t));
+				histLen -= histPos;
+				histPos = 0;
+			}
+
+			const int maxSamples = MIN<int>((SINC_HISTORY_SIZE - histLen) * (stereo ? 2 : 1), ARRAYSIZE(inBuf));
+			const int len = input.readBuffer(inBuf, maxSamples);
+			if (len <= 0)
+				return i;
+
+			const st_sample_t *inPtr = inBuf;
+			for (int j = 0; j < len / (stereo ? 2 : 1); ++j) {
+				history[0][histLen] = *inPtr++;
+				if (stereo)
+					history[stereo ? 1 : 0][histLen] = *inPtr++;
+				histLen++;
+			}
+		}
+
+		const int16 *coefs = filter->coefs + (phase * filter->phases / phaseCount) * taps;
+		for (int ch = 0; ch < (stereo ? 2 : 1); ++ch) {
+			const int32 val = (sincDotProduct(history[ch] + histPos, coefs, taps) + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS;
+			*obuf++ = (st_sample_t)CLIP<int32>(val, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		}
+
+		// Advance to the position of the next output frame
+		phase += phaseInc;
+		histPos += phase / phaseCount;
+		phase %= phaseCount;
+	}
+	return frames;
 }
 
 
@@ -293,11 +815,6 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
-		st_size_t len;
-
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -312,24 +829,14 @@ public:
 			error("[CopyRateConverter::flow] Cannot allocate memory for temp buffer");
 
 		// Read up to 'osamp' samples into our temporary buffer
-		len = input.readBuffer(_buffer, osamp);
+		const int len = input.readBuffer(_buffer, osamp);
+		if (len <= 0)
+			return 0;
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
-		return (obuf - ostart) / 2;
+		const st_size_t frames = len / (stereo ? 2 : 1);
+		mixFrames<stereo, reverseStereo>(obuf, _buffer, frames, vol_l, vol_r);
+		return frames;
 	}
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
@@ -341,9 +848,11 @@ public:
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (quality != kRateConverterQualityLow) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate, quality);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -356,14 +865,14 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterQuality quality) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, quality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, quality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, quality);
 }
 
 } // End of namespace Audio
@@ -78,7 +78,26 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+/**
+ * Quality levels for rate conversion.
+ */
+enum RateConverterQuality {
+	/** Nearest neighbor or linear interpolation; cheap, but aliases. */
+	kRateConverterQualityLow,
+	/** Short band-limited (windowed sinc) filter. */
+	kRateConverterQualityMedium,
+	/** Long band-limited (windowed sinc) filter. */
+	kRateConverterQualityHigh
+};
+
+/**
+ * Create a RateConverter for the given rates.
+ *
+ * Converters of a quality above kRateConverterQualityLow share filter
+ * tables. They may only be created and destroyed from one thread at a time,
+ * which the mixer guarantees for its channels.
+ */
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, RateConverterQuality quality = kRateConverterQualityLow);
 
 } // End of namespace Audio
 
@@ -447,7 +447,15 @@ public:
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterQuality quality) {
+	// The band-limited converters are not available in assembly, so fall
+	// back to the low quality converters.
+	static bool warnedQuality = false;
+	if (inrate != outrate && quality != kRateConverterQualityLow && !warnedQuality) {
+		warning("Resampler quality %d is not supported on this platform, using low quality", quality);
+		warnedQuality = true;
+	}
+
 	if (inrate != outrate) {
 		if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			if (stereo) {
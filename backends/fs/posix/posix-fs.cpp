@@ -33,6 +33,7 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_srandom
 
 #include "backends/fs/posix/posix-fs.h"
+#include "backends/fs/posix/posix-mmapstream.h"
 #include "backends/fs/stdiostream.h"
 #include "common/algorithm.h"
 
@@ -312,6 +313,13 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 }
 
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
+#ifdef HAS_POSIX_MMAP
+	// Large game data files are mapped, which avoids a system call for
+	// every seek and shares the data with the page cache
+	Common::SeekableReadStream *stream = PosixMmapReadStream::makeFromPath(getPath());
+	if (stream)
+		return stream;
+#endif
 	return StdioStream::makeFromPath(getPath(), false);
 }
 
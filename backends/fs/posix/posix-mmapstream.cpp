@@ -0,0 +1,84 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#if defined(POSIX) && defined(HAS_POSIX_MMAP)
+
+// Disable symbol overrides so that we can use open, mmap etc.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mmapstream.h"
+#include "common/config-manager.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+PosixMmapReadStream::PosixMmapReadStream(void *mapping, uint32 size)
+	: Common::MemoryReadStream((const byte *)mapping, size), _mapping(mapping), _mappingSize(size) {
+}
+
+PosixMmapReadStream::~PosixMmapReadStream() {
+	munmap(_mapping, _mappingSize);
+}
+
+static bool isInSavePath(const Common::String &path) {
+	Common::String savePath = ConfMan.get("savepath");
+	if (savePath.empty())
+		return false;
+
+	if (!savePath.hasSuffix("/"))
+		savePath += '/';
+	return path.hasPrefix(savePath);
+}
+
+PosixMmapReadStream *PosixMmapReadStream::makeFromPath(const Common::String &path) {
+	// Accessing a mapping past the end of a file truncated in the meantime
+	// raises SIGBUS. Savegames are rewritten while the game runs, so leave
+	// them to stdio. Game data is not expected to change under our feet.
+	if (isInSavePath(path))
+		return 0;
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+	    st.st_size < MMAP_STREAM_THRESHOLD || st.st_size > 0x7FFFFFFF) {
+		close(fd);
+		return 0;
+	}
+
+	uint32 size = (uint32)st.st_size;
+	void *mapping = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file
+	close(fd);
+
+	// Running out of address space is not fatal, stdio still works
+	if (mapping == MAP_FAILED)
+		return 0;
+
+	return new PosixMmapReadStream(mapping, size);
+}
+
+#endif
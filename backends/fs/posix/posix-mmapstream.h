@@ -0,0 +1,70 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_MMAPSTREAM_H
+#define BACKENDS_FS_POSIX_MMAPSTREAM_H
+
+#include "common/scummsys.h"
+#include "common/memstream.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+
+/**
+ * Read-only files at least this large are mapped into memory instead of
+ * being read through stdio. Smaller files are cheap to read either way and
+ * are not worth the cost of setting up a mapping.
+ */
+#define MMAP_STREAM_THRESHOLD (1024 * 1024)
+
+/**
+ * Read-only stream over a file mapped into memory with mmap().
+ *
+ * Reads and seeks are plain memory operations, so engines doing many small
+ * random reads into large archives no longer pay for a system call per
+ * seek, and the data is shared with the page cache instead of being copied
+ * into a stdio buffer. Sub streams created on top of this stream read
+ * straight from the mapping as well.
+ */
+class PosixMmapReadStream : public Common::MemoryReadStream, public Common::NonCopyable {
+private:
+	void *_mapping;
+	uint32 _mappingSize;
+
+	PosixMmapReadStream(void *mapping, uint32 size);
+
+public:
+	/**
+	 * Map the file at the given path into memory and wrap it in a
+	 * PosixMmapReadStream instance. Returns 0 if the file is smaller than
+	 * MMAP_STREAM_THRESHOLD, lies in the savegame directory, or cannot be
+	 * mapped, in which case the caller should fall back to a StdioStream.
+	 *
+	 * Reading a mapping beyond the end of a file truncated by another
+	 * process crashes with SIGBUS. Savegames are therefore never mapped,
+	 * while game data is assumed to stay unchanged while it is in use.
+	 */
+	static PosixMmapReadStream *makeFromPath(const Common::String &path);
+
+	virtual ~PosixMmapReadStream();
+};
+
+#endif
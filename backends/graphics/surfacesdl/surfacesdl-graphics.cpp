@@ -1577,12 +1577,18 @@ void SurfaceSdlGraphicsManager::copyRectToScreen(const void *buf, int pitch, int
 	assert(h > 0 && y + h <= _videoMode.screenHeight);
 	assert(w > 0 && x + w <= _videoMode.screenWidth);
 
-	addDirtyRect(x, y, w, h);
-
 	// Try to lock the screen surface
 	if (SDL_LockSurface(_screen) == -1)
 		error("SDL_LockSurface failed: %s", SDL_GetError());
 
+	// Engines often redraw (nearly) the whole screen, even when only small
+	// parts of it changed. Only mark those as dirty, so that they are the
+	// only ones which have to be scaled and sent to the screen.
+	if (w >= 2 * DIRTY_TILE_SIZE && h >= 2 * DIRTY_TILE_SIZE && !_forceRedraw)
+		addChangedRects((const byte *)buf, pitch, x, y, w, h);
+	else
+		addDirtyRect(x, y, w, h);
+
 	byte *dst = (byte *)_screen->pixels + y * _screen->pitch + x * _screenFormat.bytesPerPixel;
 	if (_videoMode.screenWidth == w && pitch == _screen->pitch) {
 		memcpy(dst, buf, h*pitch);
@@ -1709,6 +1715,89 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	}
 }
 
+void SurfaceSdlGraphicsManager::addChangedRects(const byte *src, int pitch, int x, int y, int w, int h) {
+	struct Area {
+		int x, y, w, h;
+	};
+
+	// The area is compared in tiles of DIRTY_TILE_SIZE x DIRTY_TILE_SIZE
+	// pixels. Neighboring changed tiles in a row of tiles are joined, and
+	// these spans are in turn joined with spans of the same extent in the
+	// row of tiles above.
+	Area open[NUM_DIRTY_RECT], row[NUM_DIRTY_RECT];
+	int numOpen = 0;
+
+	const int bytesPerPixel = _screenFormat.bytesPerPixel;
+	const int tilesPerRow = (w + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+	const byte *dst = (const byte *)_screen->pixels + y * _screen->pitch + x * bytesPerPixel;
+
+	for (int tileY = 0; tileY < h; tileY += DIRTY_TILE_SIZE) {
+		const int tileH = MIN<int>(DIRTY_TILE_SIZE, h - tileY);
+		const byte *srcRow = src + tileY * pitch;
+		const byte *dstRow = dst + tileY * _screen->pitch;
+
+		// Find the spans of changed tiles in this row
+		int numRow = 0;
+		int spanStart = -1;
+		for (int tile = 0; tile <= tilesPerRow; ++tile) {
+			const int tileX = tile * DIRTY_TILE_SIZE;
+			bool changed = false;
+
+			if (tile < tilesPerRow) {
+				const int lineSize = MIN<int>(DIRTY_TILE_SIZE, w - tileX) * bytesPerPixel;
+				for (int line = 0; line < tileH && !changed; ++line)
+					changed = memcmp(srcRow + line * pitch + tileX * bytesPerPixel,
+					                 dstRow + line * _screen->pitch + tileX * bytesPerPixel, lineSize) != 0;
+			}
+
+			if (changed && spanStart < 0) {
+				spanStart = tileX;
+			} else if (!changed && spanStart >= 0) {
+				if (numRow == NUM_DIRTY_RECT) {
+					addDirtyRect(x, y, w, h);
+					return;
+				}
+
+				Area &span = row[numRow++];
+				span.x = spanStart;
+				span.y = tileY;
+				span.w = MIN(tileX, w) - spanStart;
+				span.h = tileH;
+				spanStart = -1;
+			}
+		}
+
+		// Extend the areas above which line up with a span of this row, and
+		// mark all others as dirty, since they are complete now.
+		int numKept = 0;
+		for (int i = 0; i < numOpen; ++i) {
+			bool extended = false;
+			for (int j = 0; j < numRow; ++j) {
+				if (row[j].h && row[j].x == open[i].x && row[j].w == open[i].w) {
+					open[i].h += tileH;
+					row[j].h = 0;
+					extended = true;
+					break;
+				}
+			}
+
+			if (extended)
+				open[numKept++] = open[i];
+			else
+				addDirtyRect(x + open[i].x, y + open[i].y, open[i].w, open[i].h);
+		}
+
+		for (int j = 0; j < numRow; ++j) {
+			if (row[j].h)
+				open[numKept++] = row[j];
+		}
+		numOpen = numKept;
+	}
+
+	for (int i = 0; i < numOpen; ++i)
+		addDirtyRect(x + open[i].x, y + open[i].y, open[i].w, open[i].h);
+}
+
 int16 SurfaceSdlGraphicsManager::getHeight() const {
 	return _videoMode.screenHeight;
 }
@@ -341,7 +341,8 @@ protected:
 
 	enum {
 		NUM_DIRTY_RECT = 100,
-		MAX_SCALING = 3
+		MAX_SCALING = 3,
+		DIRTY_TILE_SIZE = 16
 	};
 
 	// Dirty rect management
@@ -411,6 +412,13 @@ protected:
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
 
+	/**
+	 * Mark those parts of a game screen area as dirty, which differ from the
+	 * given pixel data about to be copied there. The screen surface has to
+	 * be locked.
+	 */
+	void addChangedRects(const byte *src, int pitch, int x, int y, int w, int h);
+
 	virtual void drawMouse();
 	virtual void undrawMouse();
 	virtual void blitCursor();
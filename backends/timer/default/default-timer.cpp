@@ -22,94 +22,148 @@
 
 #include "common/scummsys.h"
 #include "backends/timer/default/default-timer.h"
+#include "common/debug.h"
 #include "common/util.h"
 #include "common/system.h"
 
+enum {
+	/**
+	 * Timers which fall behind by more than this (in microseconds), e.g.
+	 * because the process has been suspended, skip the calls they missed
+	 * instead of making up for them all at once.
+	 */
+	kMaxCatchUp = 1000 * 1000,
+
+	/** Number of buckets of the latency histogram of a timer */
+	kLatencyBuckets = 7
+};
+
 struct TimerSlot {
 	Common::TimerManager::TimerProc callback;
 	void *refCon;
 	Common::String id;
 	uint32 interval;	// in microseconds
 
-	uint32 nextFireTime;	// in milliseconds
-	uint32 nextFireTimeMicro;	// microseconds part of nextFire
+	uint64 nextFireTime;	// in microseconds
 
-	TimerSlot *next;
-
-	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0), next(nullptr) {}
-};
+	/**
+	 * How often the callback has been invoked late by 0, 1, 2-3, 4-7, 8-15,
+	 * 16-31 and 32 or more milliseconds.
+	 */
+	uint32 latency[kLatencyBuckets];
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = 0;
+	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0) {
+		memset(latency, 0, sizeof(latency));
+	}
 
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == 0 || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
+	void recordLatency(uint64 micros) {
+		const uint64 millis = micros / 1000;
+		int bucket = 0;
+		while (bucket < kLatencyBuckets - 1 && millis >= (1u << bucket))
+			++bucket;
+		++latency[bucket];
 	}
-}
 
+	void printLatency() const {
+		debug(2, "Timer '%s': called %u/%u/%u/%u/%u/%u/%u times late by 0/1/2-3/4-7/8-15/16-31/32+ ms",
+		      id.c_str(), latency[0], latency[1], latency[2], latency[3], latency[4], latency[5], latency[6]);
+	}
+};
 
 DefaultTimerManager::DefaultTimerManager() :
-	_head(0) {
-
-	_head = new TimerSlot();
+	_lastMillis(0), _millisBase(0) {
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
+	for (uint i = 0; i < _slots.size(); ++i)
+		delete _slots[i];
+	_slots.clear();
+}
+
+uint64 DefaultTimerManager::getMicros() {
+	// Extend the millisecond counter, so that timers keep working once it
+	// wraps around after 49 days.
+	const uint32 millis = g_system->getMillis(true);
+	if (millis < _lastMillis)
+		_millisBase += (uint64)1 << 32;
+	_lastMillis = millis;
+
+	return (_millisBase + millis) * 1000;
+}
+
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _slots[index];
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (_slots[parent]->nextFireTime <= slot->nextFireTime)
+			break;
+		_slots[index] = _slots[parent];
+		index = parent;
+	}
+	_slots[index] = slot;
+}
+
+void DefaultTimerManager::siftDown(uint index) {
+	TimerSlot *slot = _slots[index];
+	const uint size = _slots.size();
+	while (true) {
+		uint child = 2 * index + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && _slots[child + 1]->nextFireTime < _slots[child]->nextFireTime)
+			++child;
+		if (slot->nextFireTime <= _slots[child]->nextFireTime)
+			break;
+		_slots[index] = _slots[child];
+		index = child;
 	}
-	_head = 0;
+	_slots[index] = slot;
 }
 
 void DefaultTimerManager::handler() {
 	Common::StackLock lock(_mutex);
 
-	uint32 curTime = g_system->getMillis(true);
+	const uint64 curTime = getMicros();
 
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
-
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
+	// The slots are kept in a heap, ordered by their next fire time.
+	while (!_slots.empty() && _slots[0]->nextFireTime <= curTime) {
+		TimerSlot *slot = _slots[0];
+		slot->recordLatency(curTime - slot->nextFireTime);
+
+		// Update the fire time and move the TimerSlot to its new position.
+		// The next fire time is based on the previous one, not on the
+		// current time, so that the timer does not drift.
 		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
-		}
-		insertPrioQueue(_head, slot);
+		slot->nextFireTime += slot->interval;
+		if (slot->nextFireTime + kMaxCatchUp < curTime)
+			slot->nextFireTime = curTime + slot->interval;
+		siftDown(0);
 
 		// Invoke the timer callback
 		assert(slot->callback);
 		slot->callback(slot->refCon);
-
-		// Look at the next scheduled timer
-		slot = _head->next;
 	}
 }
 
+uint32 DefaultTimerManager::getTimeToNextTimer(uint32 maxDelay) {
+	Common::StackLock lock(_mutex);
+
+	if (_slots.empty())
+		return maxDelay;
+
+	const uint64 curTime = getMicros();
+	const uint64 nextFireTime = _slots[0]->nextFireTime;
+	if (nextFireTime <= curTime)
+		return 1;
+
+	// Round up, so that the timer is due when the handler is called
+	const uint64 delay = (nextFireTime - curTime + 999) / 1000;
+	return CLIP<uint64>(delay, 1, maxDelay);
+}
+
 bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, void *refCon, const Common::String &id) {
 	assert(interval > 0);
 	Common::StackLock lock(_mutex);
@@ -133,11 +187,10 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	slot->refCon = refCon;
 	slot->id = id;
 	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
-	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = 0;
+	slot->nextFireTime = getMicros() + interval;
 
-	insertPrioQueue(_head, slot);
+	_slots.push_back(slot);
+	siftUp(_slots.size() - 1);
 
 	return true;
 }
@@ -145,17 +198,20 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
+	uint kept = 0;
+	for (uint i = 0; i < _slots.size(); ++i) {
+		if (_slots[i]->callback == callback) {
+			_slots[i]->printLatency();
+			delete _slots[i];
 		} else {
-			slot = slot->next;
+			_slots[kept++] = _slots[i];
 		}
 	}
+	_slots.resize(kept);
+
+	// Restore the heap order
+	for (uint i = kept / 2; i-- > 0; )
+		siftDown(i);
 
 	// We need to remove all names referencing the timer proc here.
 	//
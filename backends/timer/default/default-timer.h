@@ -23,6 +23,7 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -35,9 +36,18 @@ private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
 	Common::Mutex _mutex;
-	TimerSlot *_head;
+	Common::Array<TimerSlot *> _slots; ///< binary min-heap, ordered by next fire time
 	TimerSlotMap _callbacks;
 
+	uint32 _lastMillis;
+	uint64 _millisBase;
+
+	/** Current time in microseconds, without wrapping around */
+	uint64 getMicros();
+
+	void siftUp(uint index);
+	void siftDown(uint index);
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
@@ -48,6 +58,14 @@ public:
 	 * Timer callback, to be invoked at regular time intervals by the backend.
 	 */
 	void handler();
+
+	/**
+	 * Returns the number of milliseconds until the next timer is due,
+	 * clipped to the range of 1 to maxDelay. Backends which can vary the time
+	 * until they invoke handler() again should use this, so that timers are
+	 * called as close to their schedule as possible.
+	 */
+	uint32 getTimeToNextTimer(uint32 maxDelay);
 };
 
 #endif
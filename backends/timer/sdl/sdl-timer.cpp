@@ -30,8 +30,11 @@
 #include "common/textconsole.h"
 
 static Uint32 timer_handler(Uint32 interval, void *param) {
-	((DefaultTimerManager *)param)->handler();
-	return interval;
+	DefaultTimerManager *timerManager = (DefaultTimerManager *)param;
+	timerManager->handler();
+
+	// Wake up again when the next timer is due, instead of at a fixed rate
+	return timerManager->getTimeToNextTimer(10);
 }
 
 SdlTimerManager::SdlTimerManager() {
@@ -475,6 +475,31 @@ namespace Common {
 DECLARE_SINGLETON(EngineManager);
 }
 
+static Common::Array<DetectionCache *> *s_detectionCaches = nullptr;
+static int s_detectionCacheScopes = 0;
+
+DetectionCacheScope::DetectionCacheScope() {
+	if (s_detectionCacheScopes++ == 0)
+		s_detectionCaches = new Common::Array<DetectionCache *>();
+}
+
+DetectionCacheScope::~DetectionCacheScope() {
+	if (--s_detectionCacheScopes == 0) {
+		for (uint i = 0; i < s_detectionCaches->size(); ++i)
+			delete (*s_detectionCaches)[i];
+		delete s_detectionCaches;
+		s_detectionCaches = nullptr;
+	}
+}
+
+bool DetectionCacheScope::addCache(DetectionCache *cache) {
+	if (!s_detectionCaches)
+		return false;
+
+	s_detectionCaches->push_back(cache);
+	return true;
+}
+
 /**
  * This function works for both cached and uncached PluginManagers.
  * For the cached version, most of the logic here will short circuit.
@@ -541,6 +566,11 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist) const
 	DetectedGames candidates;
 	PluginList plugins;
 	PluginList::const_iterator iter;
+
+	// Let the engines share the work of examining the files
+	DetectionCacheScope detectionCache;
+	Common::FSDirectorySnapshotScope directorySnapshot;
+
 	PluginManager::instance().loadFirstPlugin();
 	do {
 		plugins = getPlugins();
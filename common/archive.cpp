@@ -62,6 +62,62 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern)
 
 
 
+// Flushing the lookup caches is cheap, while lookups may involve expensive
+// file system accesses, so it is safe to assume that a few thousand distinct
+// file names are more than needed.
+#define LOOKUP_CACHE_SIZE 4096
+
+void SearchSet::changed() {
+	++_generation;
+
+	for (List<SearchSet *>::iterator it = _parents.begin(); it != _parents.end(); ++it)
+		(*it)->changed();
+}
+
+void SearchSet::detach(Archive *archive) {
+	SearchSet *searchSet = archive->asSearchSet();
+	if (searchSet)
+		searchSet->_parents.remove(this);
+}
+
+bool SearchSet::lookupCached(const String &name, Archive *&archive) const {
+	if (_lookupCacheGeneration != _generation) {
+		_lookupCache.clear();
+		_lookupCacheGeneration = _generation;
+		return false;
+	}
+
+	LookupCache::const_iterator it = _lookupCache.find(name);
+	if (it == _lookupCache.end())
+		return false;
+
+	archive = it->_value;
+	return true;
+}
+
+void SearchSet::addToLookupCache(const String &name, Archive *archive) const {
+	if (_lookupCache.size() >= LOOKUP_CACHE_SIZE)
+		_lookupCache.clear();
+	_lookupCache[name] = archive;
+}
+
+Archive *SearchSet::lookup(const String &name) const {
+	Archive *archive = nullptr;
+	if (lookupCached(name, archive))
+		return archive;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (it->_arc->hasFile(name)) {
+			archive = it->_arc;
+			break;
+		}
+	}
+
+	addToLookupCache(name, archive);
+	return archive;
+}
+
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
@@ -92,12 +148,17 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	changed();
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
 	if (find(name) == _list.end()) {
 		Node node(priority, name, archive, autoFree);
 		insert(node);
+
+		SearchSet *searchSet = archive->asSearchSet();
+		if (searchSet)
+			searchSet->_parents.push_back(this);
 	} else {
 		if (autoFree)
 			delete archive;
@@ -119,8 +180,12 @@ void SearchSet::addDirectory(const String &name, const FSNode &dir, int priority
 }
 
 void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPattern, bool ignoreCase, int priority, int depth, bool flat) {
+	// Matching a pattern with several components lists the same
+	// directories again for every match
+	FSDirectorySnapshotScope snapshot;
+
 	FSList subDirs;
-	if (!directory.getChildren(subDirs))
+	if (!FSDirectory::listDirectory(directory, subDirs))
 		return;
 
 	String nextPattern, pattern;
@@ -144,6 +209,9 @@ void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPa
 	MatchList::iterator matchIter;
 
 	for (FSList::const_iterator i = subDirs.begin(); i != subDirs.end(); ++i) {
+		if (!i->isDirectory())
+			continue;
+
 		String name = i->getName();
 
 		if (matchString(name.c_str(), pattern.c_str(), ignoreCase)) {
@@ -170,9 +238,11 @@ void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPa
 void SearchSet::remove(const String &name) {
 	ArchiveNodeList::iterator it = find(name);
 	if (it != _list.end()) {
+		detach(it->_arc);
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		changed();
 	}
 }
 
@@ -182,11 +252,13 @@ bool SearchSet::hasArchive(const String &name) const {
 
 void SearchSet::clear() {
 	for (ArchiveNodeList::iterator i = _list.begin(); i != _list.end(); ++i) {
+		detach(i->_arc);
 		if (i->_autoFree)
 			delete i->_arc;
 	}
 
 	_list.clear();
+	changed();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -209,13 +281,7 @@ bool SearchSet::hasFile(const String &name) const {
 	if (name.empty())
 		return false;
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return true;
-	}
-
-	return false;
+	return lookup(name) != nullptr;
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
@@ -242,11 +308,9 @@ const ArchiveMemberPtr SearchSet::getMember(const String &name) const {
 	if (name.empty())
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return it->_arc->getMember(name);
-	}
+	Archive *archive = lookup(name);
+	if (archive)
+		return archive->getMember(name);
 
 	return ArchiveMemberPtr();
 }
@@ -255,12 +319,9 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	if (name.empty())
 		return nullptr;
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
-		if (stream)
-			return stream;
-	}
+	Archive *archive = lookup(name);
+	if (archive)
+		return archive->createReadStreamForMember(name);
 
 	return nullptr;
 }
@@ -24,6 +24,8 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/hash-str.h"
+#include "common/flathashmap.h"
 #include "common/list.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
@@ -31,6 +33,7 @@
 namespace Common {
 
 class FSNode;
+class SearchSet;
 class SeekableReadStream;
 
 
@@ -123,6 +126,15 @@ public:
 	 * @return the newly created input stream
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const = 0;
+
+private:
+	friend class SearchSet;
+
+	/**
+	 * Return this archive if it is a SearchSet, so that search sets can tell
+	 * the search sets they are nested in about changes.
+	 */
+	virtual SearchSet *asSearchSet() { return nullptr; }
 };
 
 
@@ -146,6 +158,45 @@ class SearchSet : public Archive {
 	typedef List<Node> ArchiveNodeList;
 	ArchiveNodeList _list;
 
+	/**
+	 * Remembers for file names looked up before which archive contains them,
+	 * or nullptr if none does, so that repeated lookups, and in particular
+	 * failing ones, do not have to ask every archive again.
+	 *
+	 * The cache is flushed whenever this set, or a search set nested in it,
+	 * changes. Files appearing in or vanishing from the archives in the
+	 * meantime go unnoticed, just like FSDirectory does not notice them
+	 * once it cached a directory. File names are matched ignoring case,
+	 * as the archives do.
+	 */
+	typedef FlatHashMap<String, Archive *, IgnoreCase_Hash, IgnoreCase_EqualTo> LookupCache;
+	mutable LookupCache _lookupCache;
+	mutable uint32 _lookupCacheGeneration;
+	uint32 _generation;
+
+	/** The search sets this set was added to */
+	List<SearchSet *> _parents;
+
+	/** Invalidate the lookup caches of this set and all sets containing it */
+	void changed();
+
+	/** Forget about a nested search set before it is removed */
+	void detach(Archive *archive);
+
+	SearchSet *asSearchSet() { return this; }
+
+	/**
+	 * Look up a name in the lookup cache.
+	 *
+	 * @return true if the name is cached. In this case, archive is set to the
+	 *         archive containing the file, or to nullptr if there is none.
+	 */
+	bool lookupCached(const String &name, Archive *&archive) const;
+	void addToLookupCache(const String &name, Archive *archive) const;
+
+	/** Find the archive containing a file, and cache the result */
+	Archive *lookup(const String &name) const;
+
 	ArchiveNodeList::iterator find(const String &name);
 	ArchiveNodeList::const_iterator find(const String &name) const;
 
@@ -153,6 +204,7 @@ class SearchSet : public Archive {
 	void insert(const Node& node);
 
 public:
+	SearchSet() : _lookupCacheGeneration(0), _generation(0) {}
 	virtual ~SearchSet() { clear(); }
 
 	/**
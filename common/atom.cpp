@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/atom.h"
+#include "common/hash-str.h"
+
+namespace Common {
+
+// Heap allocated on first use, so that there is no static constructor and
+// atoms may be created at any time. The atoms stored in the table do not
+// count as references to their entries, which lets find() hand them out
+// without modifying anything.
+typedef HashMap<String, Atom, IgnoreCase_Hash, IgnoreCase_EqualTo> AtomTable;
+static AtomTable *s_atomTable = nullptr;
+
+Atom::Atom(const String &name) : _entry(nullptr) {
+	if (name.empty())
+		return;
+
+	if (!s_atomTable)
+		s_atomTable = new AtomTable();
+
+	Atom &slot = (*s_atomTable)[name];
+	if (!slot._entry) {
+		Entry *entry = new Entry();
+		entry->_name = name;
+		entry->_hash = hashit_lower(name);
+		entry->_refCount = 0;
+		slot._entry = entry;
+	}
+
+	_entry = slot._entry;
+	incRef();
+}
+
+Atom &Atom::operator=(const Atom &atom) {
+	atom.incRef();
+	decRef();
+	_entry = atom._entry;
+	return *this;
+}
+
+const Atom *Atom::find(const String &name) {
+	if (!s_atomTable || name.empty())
+		return nullptr;
+
+	AtomTable::const_iterator it = s_atomTable->find(name);
+	if (it == s_atomTable->end())
+		return nullptr;
+
+	return &it->_value;
+}
+
+const String &Atom::toString() const {
+	static const String emptyString;
+	return _entry ? _entry->_name : emptyString;
+}
+
+void Atom::incRef() const {
+	if (_entry)
+		_entry->_refCount++;
+}
+
+void Atom::decRef() {
+	if (!_entry || --_entry->_refCount > 0)
+		return;
+
+	// Keep the table's own atom from releasing the entry once more
+	Entry *entry = _entry;
+	AtomTable::iterator it = s_atomTable->find(entry->_name);
+	it->_value._entry = nullptr;
+	s_atomTable->erase(it);
+	delete entry;
+	_entry = nullptr;
+
+	if (s_atomTable->empty()) {
+		delete s_atomTable;
+		s_atomTable = nullptr;
+	}
+}
+
+} // End of namespace Common
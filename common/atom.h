@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOM_H
+#define COMMON_ATOM_H
+
+#include "common/str.h"
+#include "common/func.h"
+
+namespace Common {
+
+/**
+ * An interned, case insensitive name.
+ *
+ * All atoms created from strings which only differ in case share a single
+ * entry, which holds the name as first spelled and its case insensitive hash.
+ * Comparing and hashing atoms therefore only needs the entry pointer, which
+ * makes them cheap keys for tables built once and queried often, like the
+ * file caches of FSDirectory.
+ *
+ * Entries are reference counted and released once the last atom referring to
+ * them is gone. The null atom, created by the default constructor or from an
+ * empty string, refers to no entry.
+ *
+ * Neither the table of entries nor the reference counts are synchronized, so
+ * atoms may only be created, copied and destroyed by one thread at a time.
+ * find() does neither and only reads the table.
+ */
+class Atom {
+	struct Entry {
+		String _name;
+		uint _hash;
+		uint _refCount;
+	};
+
+	Entry *_entry;
+
+	void incRef() const;
+	void decRef();
+
+public:
+	Atom() : _entry(nullptr) {}
+	explicit Atom(const String &name);
+	Atom(const Atom &atom) : _entry(atom._entry) { incRef(); }
+	~Atom() { decRef(); }
+
+	Atom &operator=(const Atom &atom);
+
+	/**
+	 * Look up the atom for the given name without interning it or touching
+	 * any reference count. Returns nullptr if no atom with that name exists;
+	 * since every key of a table of atoms exists as an atom, looking up a
+	 * missing name stops here without probing the table.
+	 *
+	 * The returned atom is owned by the table of entries and stays valid
+	 * as long as some other atom refers to the same entry.
+	 */
+	static const Atom *find(const String &name);
+
+	bool empty() const { return _entry == nullptr; }
+
+	/** The name as first interned, or an empty string for the null atom. */
+	const String &toString() const;
+	const char *c_str() const { return toString().c_str(); }
+
+	/** Case insensitive hash of the name, equal to hashit_lower(). */
+	uint hash() const { return _entry ? _entry->_hash : 0; }
+
+	bool operator==(const Atom &x) const { return _entry == x._entry; }
+	bool operator!=(const Atom &x) const { return _entry != x._entry; }
+};
+
+template<>
+struct Hash<Atom> {
+	uint operator()(const Atom &atom) const {
+		return atom.hash();
+	}
+};
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * Minimal set of atomic operations for exchanging data between threads
+ * without taking a mutex, e.g. between game code and the audio callback.
+ *
+ * Loads have acquire semantics and stores have release semantics, which is
+ * what is needed for publishing data from one thread to another. Only
+ * naturally aligned values up to the native word size may be used.
+ */
+
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+
+template<typename T>
+inline T atomicLoad(const T *ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+template<typename T>
+inline void atomicStore(T *ptr, T value) {
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+inline bool atomicCompareAndSwap(int32 *ptr, int32 expected, int32 desired) {
+	return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+#elif defined(__GNUC__)
+
+// Older GCC versions only provide the full barrier __sync builtins
+template<typename T>
+inline T atomicLoad(const T *ptr) {
+	T value = *(const volatile T *)ptr;
+	__sync_synchronize();
+	return value;
+}
+
+template<typename T>
+inline void atomicStore(T *ptr, T value) {
+	__sync_synchronize();
+	*(volatile T *)ptr = value;
+}
+
+inline bool atomicCompareAndSwap(int32 *ptr, int32 expected, int32 desired) {
+	return __sync_bool_compare_and_swap(ptr, expected, desired);
+}
+
+#elif defined(_MSC_VER)
+
+// MSVC gives volatile accesses acquire/release semantics; the compiler
+// barrier keeps the optimizer from moving other accesses across them.
+template<typename T>
+inline T atomicLoad(const T *ptr) {
+	T value = *(const volatile T *)ptr;
+	_ReadWriteBarrier();
+	return value;
+}
+
+template<typename T>
+inline void atomicStore(T *ptr, T value) {
+	_ReadWriteBarrier();
+	*(volatile T *)ptr = value;
+}
+
+inline bool atomicCompareAndSwap(int32 *ptr, int32 expected, int32 desired) {
+	return _InterlockedCompareExchange((volatile long *)ptr, desired, expected) == expected;
+}
+
+#else
+#error "No atomic operations available for this compiler"
+#endif
+
+} // End of namespace Common
+
+#endif
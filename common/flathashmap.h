@@ -0,0 +1,454 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The open addressing scheme in this file follows the "Swiss table" design
+// used by Abseil's flat_hash_map: one control byte per slot, probed a
+// group of slots at a time.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/endian.h"
+#include "common/func.h"
+
+namespace Common {
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val> which
+ * stores its entries inline instead of in separately allocated nodes.
+ *
+ * Next to the entry array the map keeps one control byte per slot, which is
+ * either empty, deleted, or holds 7 bits of the key's hash. Lookups compare
+ * a whole group of eight control bytes against the hash in a few integer
+ * operations, and only touch the entries whose bits match, so most failed
+ * comparisons never leave the control byte array.
+ *
+ * The interface is the same as HashMap's, with one difference: since entries
+ * are stored inline, adding a key may move all entries. References and
+ * iterators into the map are therefore invalidated by operator[], getVal and
+ * setVal on a missing key, as they are for Array. Erasing never moves
+ * entries.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+		FLATHASHMAP_GROUP_WIDTH = 8,
+
+		// The map grows once more than 7/8 of its slots are in use,
+		// counting deleted ones.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	enum {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+		// Full slots hold the low 7 bits of the hash, so their top bit is clear
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	/**
+	 * Control bytes, one per slot. The first group is repeated after the
+	 * last slot so a group can be loaded from any position without wrapping.
+	 */
+	byte *_ctrl;
+	Node *_slots;	///< Raw storage for capacity entries, constructed where the control byte is full
+	size_type _mask;	///< Capacity of the map minus one; the capacity is a power of two
+	size_type _size;
+	size_type _deleted;	///< Number of deleted slots
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static bool isFull(byte ctrl) { return (ctrl & 0x80) == 0; }
+
+	/**
+	 * Spread the hash over all bits. Many of our hash functions are the
+	 * identity, which would otherwise put consecutive keys into the same
+	 * group with the same control byte.
+	 */
+	static uint32 mixHash(uint hash) { return (uint32)hash * 0x9E3779B1; }
+	static byte h2(uint32 hash) { return hash >> 25; }
+
+	static uint64 groupMatch(uint64 group, byte value) {
+		// Classic "has zero byte" test on group ^ value. It may report
+		// false positives above a real match, which the key comparison
+		// filters out, but never misses one.
+		const uint64 lsbs = 0x0101010101010101ULL;
+		const uint64 msbs = 0x8080808080808080ULL;
+		const uint64 x = group ^ (lsbs * value);
+		return (x - lsbs) & ~x & msbs;
+	}
+
+	static uint64 groupMatchEmpty(uint64 group) {
+		// Empty is the only control value with the top bit set and bit 1 clear
+		return group & (~group << 6) & 0x8080808080808080ULL;
+	}
+
+	static uint64 groupMatchEmptyOrDeleted(uint64 group) {
+		return group & 0x8080808080808080ULL;
+	}
+
+	/** Return the index within the group of the lowest match and clear it. */
+	static uint nextMatch(uint64 &matches) {
+#if GCC_ATLEAST(3, 4)
+		const uint idx = __builtin_ctzll(matches) / 8;
+#else
+		uint idx = 0;
+		while (!(matches & (0x80ULL << (idx * 8))))
+			idx++;
+#endif
+		matches &= matches - 1;
+		return idx;
+	}
+
+	uint64 loadGroup(size_type pos) const { return READ_LE_UINT64(_ctrl + pos); }
+
+	void setCtrl(size_type idx, byte ctrl) {
+		_ctrl[idx] = ctrl;
+		if (idx < FLATHASHMAP_GROUP_WIDTH)
+			_ctrl[_mask + 1 + idx] = ctrl;
+	}
+
+	void allocStorage(size_type capacity) {
+		_mask = capacity - 1;
+		_ctrl = new byte[capacity + FLATHASHMAP_GROUP_WIDTH];
+		assert(_ctrl != nullptr);
+		memset(_ctrl, kCtrlEmpty, capacity + FLATHASHMAP_GROUP_WIDTH);
+		_slots = (Node *)malloc(capacity * sizeof(Node));
+		assert(_slots != nullptr);
+	}
+
+	void freeStorage() {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				_slots[ctr].~Node();
+		}
+		delete[] _ctrl;
+		free(_slots);
+	}
+
+	size_type findFreeSlot(uint32 hash) const;
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(isFull(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextFull(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	size_type nextFull(size_type idx) const {
+		while (idx <= _mask && !isFull(_ctrl[idx]))
+			idx++;
+		return idx > _mask ? (size_type)-1 : idx;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		freeStorage();
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const {
+		return lookup(key) != (size_type)-1;
+	}
+
+	Val &operator[](const Key &key) { return getVal(key); }
+	const Val &operator[](const Key &key) const { return getVal(key); }
+
+	Val &getVal(const Key &key) {
+		// Look up first, the call may move _slots
+		size_type ctr = lookupAndCreateIfMissing(key);
+		return _slots[ctr]._value;
+	}
+
+	const Val &getVal(const Key &key) const {
+		return getVal(key, _defaultVal);
+	}
+
+	const Val &getVal(const Key &key, const Val &defaultVal) const {
+		size_type ctr = lookup(key);
+		return ctr != (size_type)-1 ? _slots[ctr]._value : defaultVal;
+	}
+
+	void setVal(const Key &key, const Val &val) {
+		size_type ctr = lookupAndCreateIfMissing(key);
+		_slots[ctr]._value = val;
+	}
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator begin() { return iterator(nextFull(0), this); }
+	iterator end() { return iterator((size_type)-1, this); }
+	const_iterator begin() const { return const_iterator(nextFull(0), this); }
+	const_iterator end() const { return const_iterator((size_type)-1, this); }
+
+	iterator find(const Key &key) { return iterator(lookup(key), this); }
+	const_iterator find(const Key &key) const { return const_iterator(lookup(key), this); }
+
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap to this
+ * one. The layout is copied as is, so no key needs to be hashed again.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+	memcpy(_ctrl, map._ctrl, map._mask + 1 + FLATHASHMAP_GROUP_WIDTH);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			new ((void *)&_slots[ctr]) Node(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				_slots[ctr].~Node();
+		}
+		memset(_ctrl, kCtrlEmpty, _mask + 1 + FLATHASHMAP_GROUP_WIDTH);
+	}
+
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Find the first empty or deleted slot on the probe sequence of the given
+ * hash. The sequence visits every group once the step has grown to the
+ * capacity, and the load factor guarantees there is a free slot.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(uint32 hash) const {
+	size_type pos = hash & _mask;
+	for (size_type step = FLATHASHMAP_GROUP_WIDTH; ; step += FLATHASHMAP_GROUP_WIDTH) {
+		uint64 matches = groupMatchEmptyOrDeleted(loadGroup(pos));
+		if (matches)
+			return (pos + nextMatch(matches)) & _mask;
+		pos = (pos + step) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	byte *oldCtrl = _ctrl;
+	Node *oldSlots = _slots;
+	const size_type oldMask = _mask;
+
+	allocStorage(newCapacity);
+	_deleted = 0;
+
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (!isFull(oldCtrl[ctr]))
+			continue;
+
+		// Keys are unique, so there is no need to compare them here
+		const uint32 hash = mixHash(_hash(oldSlots[ctr]._key));
+		const size_type idx = findFreeSlot(hash);
+		setCtrl(idx, h2(hash));
+		new ((void *)&_slots[idx]) Node(oldSlots[ctr]);
+		oldSlots[ctr].~Node();
+	}
+
+	delete[] oldCtrl;
+	free(oldSlots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const uint32 hash = mixHash(_hash(key));
+	const byte tag = h2(hash);
+	size_type pos = hash & _mask;
+	for (size_type step = FLATHASHMAP_GROUP_WIDTH; step <= _mask + 1 + FLATHASHMAP_GROUP_WIDTH; step += FLATHASHMAP_GROUP_WIDTH) {
+		const uint64 group = loadGroup(pos);
+		for (uint64 matches = groupMatch(group, tag); matches; ) {
+			const size_type idx = (pos + nextMatch(matches)) & _mask;
+			if (_ctrl[idx] == tag && _equal(_slots[idx]._key, key))
+				return idx;
+		}
+		if (groupMatchEmpty(group))
+			break;
+		pos = (pos + step) & _mask;
+	}
+	return (size_type)-1;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return ctr;
+
+	// Keep the load factor below a certain threshold. Deleted slots are
+	// also counted; if they make up most of the load, rehashing at the same
+	// capacity is enough to get rid of them.
+	const size_type capacity = _mask + 1;
+	if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		if (_deleted > _size)
+			rehash(capacity);
+		else
+			rehash(capacity * 2);
+	}
+
+	const uint32 hash = mixHash(_hash(key));
+	ctr = findFreeSlot(hash);
+	if (_ctrl[ctr] == kCtrlDeleted)
+		_deleted--;
+	setCtrl(ctr, h2(hash));
+	new ((void *)&_slots[ctr]) Node(key);
+	_size++;
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(isFull(_ctrl[ctr]));
+
+	// Mark the slot deleted rather than empty, so that probe sequences
+	// running through it keep going.
+	_slots[ctr].~Node();
+	setCtrl(ctr, kCtrlDeleted);
+	_size--;
+	_deleted++;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		erase(iterator(ctr, this));
+}
+
+} // End of namespace Common
+
+#endif
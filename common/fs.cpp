@@ -27,6 +27,28 @@
 
 namespace Common {
 
+/** Directory listings keyed by path; see FSDirectorySnapshotScope */
+typedef HashMap<String, FSList> DirectorySnapshot;
+static DirectorySnapshot *s_directorySnapshot = nullptr;
+static int s_directorySnapshotUsers = 0;
+
+FSDirectorySnapshotScope::FSDirectorySnapshotScope() {
+	if (s_directorySnapshotUsers++ == 0)
+		s_directorySnapshot = new DirectorySnapshot();
+}
+
+FSDirectorySnapshotScope::~FSDirectorySnapshotScope() {
+	if (--s_directorySnapshotUsers == 0) {
+		delete s_directorySnapshot;
+		s_directorySnapshot = nullptr;
+	}
+}
+
+static void invalidateDirectorySnapshot() {
+	if (s_directorySnapshot)
+		s_directorySnapshot->clear();
+}
+
 FSNode::FSNode() {
 }
 
@@ -149,6 +171,7 @@ WriteStream *FSNode::createWriteStream() const {
 		return nullptr;
 	}
 
+	invalidateDirectorySnapshot();
 	return _realNode->createWriteStream();
 }
 
@@ -165,6 +188,7 @@ bool FSNode::createDirectory() const {
 		return false;
 	}
 
+	invalidateDirectorySnapshot();
 	return _realNode->createDirectory();
 }
 
@@ -202,13 +226,37 @@ FSNode FSDirectory::getFSNode() const {
 	return _node;
 }
 
+bool FSDirectory::listDirectory(const FSNode &node, FSList &list) {
+	if (!s_directorySnapshot)
+		return node.getChildren(list, FSNode::kListAll);
+
+	const String path = node.getPath();
+	DirectorySnapshot::const_iterator it = s_directorySnapshot->find(path);
+	if (it != s_directorySnapshot->end()) {
+		list = it->_value;
+		return true;
+	}
+
+	if (!node.getChildren(list, FSNode::kListAll))
+		return false;
+
+	(*s_directorySnapshot)[path] = list;
+	return true;
+}
+
 FSNode *FSDirectory::lookupCache(NodeCache &cache, const String &name) const {
 	// make caching as lazy as possible
 	if (!name.empty()) {
 		ensureCached();
 
-		if (cache.contains(name))
-			return &cache[name];
+		// Every key is an atom, so names without one are not cached
+		const Atom *key = Atom::find(name);
+		if (!key)
+			return nullptr;
+
+		NodeCache::iterator it = cache.find(*key);
+		if (it != cache.end())
+			return &it->_value;
 	}
 
 	return nullptr;
@@ -273,7 +321,7 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const String&
 		return;
 
 	FSList list;
-	node.getChildren(list, FSNode::kListAll);
+	listDirectory(node, list);
 
 	FSList::iterator it = list.begin();
 	for ( ; it != list.end(); ++it) {
@@ -282,23 +330,24 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const String&
 		// don't touch name as it might be used for warning messages
 		String lowercaseName = name;
 		lowercaseName.toLowercase();
+		Atom key(lowercaseName);
 
-		// since the hashmap is case insensitive, we need to check for clashes when caching
+		// since atoms are case insensitive, we need to check for clashes when caching
 		if (it->isDirectory()) {
-			if (!_flat && _subDirCache.contains(lowercaseName)) {
+			if (!_flat && _subDirCache.contains(key)) {
 				warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring sub-directory '%s'", name.c_str());
 			} else {
-				if (_subDirCache.contains(lowercaseName)) {
+				if (_subDirCache.contains(key)) {
 					warning("FSDirectory::cacheDirectory: name clash when building subDirCache with subdirectory '%s'", name.c_str());
 				}
 				cacheDirectoryRecursive(*it, depth - 1, _flat ? prefix : lowercaseName + "/");
-				_subDirCache[lowercaseName] = *it;
+				_subDirCache[key] = *it;
 			}
 		} else {
-			if (_fileCache.contains(lowercaseName)) {
+			if (_fileCache.contains(key)) {
 				warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring file '%s'", name.c_str());
 			} else {
-				_fileCache[lowercaseName] = *it;
+				_fileCache[key] = *it;
 			}
 		}
 	}
@@ -319,15 +368,12 @@ int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const String &patt
 	// Cache dir data
 	ensureCached();
 
-	// need to match lowercase key, since all entries in our file cache are
-	// stored as lowercase.
-	String lowercasePattern(pattern);
-	lowercasePattern.toLowercase();
-
+	// Atoms keep the spelling they were first created with, which need not
+	// be the lowercase one we cached them with, so ignore case here.
 	int matches = 0;
 	NodeCache::const_iterator it = _fileCache.begin();
 	for ( ; it != _fileCache.end(); ++it) {
-		if (it->_key.matchString(lowercasePattern, false, true)) {
+		if (it->_key.toString().matchString(pattern, true, true)) {
 			list.push_back(ArchiveMemberPtr(new FSNode(it->_value)));
 			matches++;
 		}
@@ -25,8 +25,10 @@
 
 #include "common/array.h"
 #include "common/archive.h"
+#include "common/atom.h"
 #include "common/hash-str.h"
 #include "common/hashmap.h"
+#include "common/noncopyable.h"
 #include "common/ptr.h"
 #include "common/str.h"
 
@@ -282,8 +284,8 @@ class FSDirectory : public Archive {
 	void setPrefix(const String &prefix);
 
 	// Caches are case insensitive, clashes are dealt with when creating
-	// Key is stored in lowercase.
-	typedef HashMap<String, FSNode, IgnoreCase_Hash, IgnoreCase_EqualTo> NodeCache;
+	// Key is created from the lowercase name.
+	typedef HashMap<Atom, FSNode> NodeCache;
 	mutable NodeCache	_fileCache, _subDirCache;
 	mutable bool _cached;
 	mutable int	_depth;
@@ -323,6 +325,16 @@ public:
 	 */
 	FSNode getFSNode() const;
 
+	/**
+	 * List all files and directories in a directory, like
+	 * FSNode::getChildren(list, FSNode::kListAll) does.
+	 *
+	 * While an FSDirectorySnapshotScope exists, listings are reused, as the
+	 * same directories are typically scanned several times in a row when
+	 * detecting or starting a game, which is slow on network file systems.
+	 */
+	static bool listDirectory(const FSNode &node, FSList &list);
+
 	/**
 	 * Create a new FSDirectory pointing to a sub directory of the instance. See class comment
 	 * for an explanation of the prefix parameter.
@@ -360,6 +372,22 @@ public:
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 };
 
+/**
+ * While an object of this class exists, FSDirectory::listDirectory() keeps
+ * the directory listings it makes, and returns them again instead of asking
+ * the file system.
+ *
+ * Creating files or directories through FSNode drops the listings, but
+ * changes made behind ScummVM's back are not noticed, so a scope should
+ * only span a single scan. Scopes may be nested; the listings are dropped
+ * when the outermost one ends.
+ */
+class FSDirectorySnapshotScope : NonCopyable {
+public:
+	FSDirectorySnapshotScope();
+	~FSDirectorySnapshotScope();
+};
+
 
 } // End of namespace Common
 
@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_LOCKFREE_QUEUE_H
+#define COMMON_LOCKFREE_QUEUE_H
+
+#include "common/atomic.h"
+
+namespace Common {
+
+/**
+ * Fixed capacity FIFO for passing values from exactly one producer thread
+ * to exactly one consumer thread without locking.
+ *
+ * push() may only be called from the producer and pop() only from the
+ * consumer; neither ever blocks. If several threads need to push, they have
+ * to serialize among themselves (e.g. with a Common::Mutex), which still
+ * leaves the consumer side lock-free.
+ *
+ * @tparam T    Value type; it is copied in and out of the queue.
+ * @tparam size Capacity of the queue, has to be a power of two.
+ */
+template<class T, uint size>
+class LockFreeQueue {
+public:
+	LockFreeQueue() : _head(0), _tail(0) {}
+
+	/**
+	 * Append a value to the queue.
+	 *
+	 * @return false when the queue is full, in which case nothing is added.
+	 */
+	bool push(const T &value) {
+		const uint32 tail = _tail;
+		if (tail - atomicLoad(&_head) == size)
+			return false;
+
+		_buffer[tail & (size - 1)] = value;
+		atomicStore(&_tail, tail + 1);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest value from the queue.
+	 *
+	 * @return false when the queue is empty, in which case value is untouched.
+	 */
+	bool pop(T &value) {
+		const uint32 head = _head;
+		if (head == atomicLoad(&_tail))
+			return false;
+
+		value = _buffer[head & (size - 1)];
+		atomicStore(&_head, head + 1);
+		return true;
+	}
+
+	/**
+	 * Whether the queue is empty. Only reliable when called from the
+	 * consumer, since the producer may add values at any time.
+	 */
+	bool empty() const {
+		return atomicLoad(&_head) == atomicLoad(&_tail);
+	}
+
+private:
+	// Only compile for power of two sizes, so the free running counters wrap
+	// around correctly.
+	typedef char SizeMustBePowerOfTwo[(size != 0 && (size & (size - 1)) == 0) ? 1 : -1];
+
+	T _buffer[size];
+	uint32 _head; ///< Index of the next value to pop, written by the consumer only.
+	uint32 _tail; ///< Index of the next free slot, written by the producer only.
+};
+
+} // End of namespace Common
+
+#endif
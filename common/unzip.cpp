@@ -106,6 +106,10 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/textconsole.h"
+#include "common/zlib.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -382,6 +386,8 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owns _stream, shared with
+													streams of archive members */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -544,6 +550,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -595,7 +602,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -644,7 +650,6 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -1419,6 +1424,75 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+/**
+ * Members at least this big are decompressed on the fly while being read,
+ * instead of being decompressed into memory as a whole when opened.
+ */
+#define ZIP_STREAMING_THRESHOLD (256 * 1024)
+
+/**
+ * Stream for the raw data of an archive member. It keeps the archive's
+ * stream alive, so it can outlive the ZipArchive it was created from, and
+ * several of them can be used at the same time.
+ */
+class ZipMemberDataStream : public SafeSeekableSubReadStream {
+	SharedPtr<SeekableReadStream> _archiveStream;
+
+public:
+	ZipMemberDataStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 begin, uint32 end)
+		: SafeSeekableSubReadStream(archiveStream.get(), begin, end), _archiveStream(archiveStream) {
+	}
+};
+
+#ifdef USE_ZLIB
+/**
+ * Stream checking the CRC of a streamed archive member once it was read up
+ * to its end. Only data read in order is accounted for; if parts of the
+ * member were skipped, its CRC cannot be verified.
+ *
+ * A mismatch is reported through err(), which stays set even after a call
+ * to clearErr(), as the data read is known to be corrupt.
+ */
+class ZipMemberCRCStream : public SeekableReadStream {
+	ScopedPtr<SeekableReadStream> _parentStream;
+	const String _name;
+	const uLong _expectedCRC;
+	uLong _crc;
+	uint32 _crcPos;		///< end of the data accounted for in _crc
+	bool _crcError;
+
+public:
+	ZipMemberCRCStream(SeekableReadStream *parentStream, const String &name, uLong crc)
+		: _parentStream(parentStream), _name(name), _expectedCRC(crc), _crc(0), _crcPos(0), _crcError(false) {
+	}
+
+	bool eos() const { return _parentStream->eos(); }
+	bool err() const { return _crcError || _parentStream->err(); }
+	void clearErr() { _parentStream->clearErr(); }
+
+	int32 pos() const { return _parentStream->pos(); }
+	int32 size() const { return _parentStream->size(); }
+	bool seek(int32 offset, int whence = SEEK_SET) { return _parentStream->seek(offset, whence); }
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		const uint32 start = _parentStream->pos();
+		const uint32 actual = _parentStream->read(dataPtr, dataSize);
+
+		if (start <= _crcPos && start + actual > _crcPos) {
+			const uint32 skip = _crcPos - start;
+			_crc = crc32(_crc, (const Bytef *)dataPtr + skip, actual - skip);
+			_crcPos = start + actual;
+
+			if (_crcPos == (uint32)size() && _crc != _expectedCRC) {
+				warning("ZipArchive: CRC mismatch in '%s'", _name.c_str());
+				_crcError = true;
+			}
+		}
+
+		return actual;
+	}
+};
+#endif
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
@@ -1496,6 +1570,27 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
 		return nullptr;
 
+	if (fileInfo.uncompressed_size >= ZIP_STREAMING_THRESHOLD) {
+		// Large members are read straight from the archive, so they do not
+		// have to be held in memory as a whole. Their CRC is verified once
+		// they are read up to the end.
+		const unz_s *const archive = (const unz_s *)_zipFile;
+		const uint32 begin = archive->pfile_in_zip_read->pos_in_zipfile + archive->byte_before_the_zipfile;
+		const uint32 end = begin + fileInfo.compressed_size;
+		const bool stored = (fileInfo.compression_method == 0);
+		unzCloseCurrentFile(_zipFile);
+
+		SeekableReadStream *stream = new ZipMemberDataStream(archive->_streamRef, begin, end);
+		if (!stored)
+			stream = wrapDeflateReadStream(stream, fileInfo.uncompressed_size, true);
+
+#ifdef USE_ZLIB
+		// Like unzCloseCurrentFile(), only check the CRC with zlib available
+		stream = new ZipMemberCRCStream(stream, name, fileInfo.crc);
+#endif
+		return stream;
+	}
+
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
 	assert(buffer);
 
@@ -1510,11 +1605,6 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	}
 
 	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
-
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
 }
 
 Archive *makeZipArchive(const String &name) {
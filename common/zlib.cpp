@@ -24,6 +24,7 @@
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
 #include "common/zlib.h"
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -141,19 +142,62 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
 	return true;
 }
 
+/**
+ * Initial distance between two checkpoints of a seek index, in bytes of
+ * decompressed data.
+ */
+#define DEFLATE_CHECKPOINT_INTERVAL (1024 * 1024)
+
+/**
+ * Initial checkpoint distance for gzip and zlib streams. These are mostly
+ * savegames and engine data files of moderate size, which are often read
+ * back and forth, so a denser index pays off.
+ */
+#define GZIP_CHECKPOINT_INTERVAL (64 * 1024)
+
+/**
+ * Minimal size of the compressed data for gzip and zlib streams to get a
+ * seek index. Restarting smaller streams from the start is cheap enough.
+ */
+#define GZIP_CHECKPOINT_MIN_SIZE (256 * 1024)
+
 #ifndef RELEASE_BUILD
 static bool _shownBackwardSeekingWarning = false;
 #endif
 
+// Restoring the decompressor state at an arbitrary position needs
+// inflateGetDictionary(), which was added in zlib 1.2.7.1.
+#if ZLIB_VERNUM >= 0x1271
+#define USE_INFLATE_CHECKPOINTS
+#endif
+
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
- * Assumes the compressed data to be in gzip format.
+ * Assumes the compressed data to be in gzip or zlib format, or to be raw
+ * deflate data if rawDeflate is set.
+ *
+ * Backward seeks normally restart the decompression from the start. If a
+ * checkpoint interval is given, the stream records the decompressor state
+ * roughly every that many bytes of output while reading, and seeks resume
+ * from the nearest checkpoint instead. Every checkpoint holds a copy of the
+ * 32 KiB inflate window, so their number is bounded by MAX_CHECKPOINTS; once
+ * that many exist, every other one is dropped and the interval doubled.
  */
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		BUFSIZE = 16384,		// 1 << MAX_WBITS
+		WINDOWSIZE = 32768,		// maximal deflate window size
+		MAX_CHECKPOINTS = 8
+	};
+
+	struct Checkpoint {
+		uint32 outPos;     ///< position in the decompressed data
+		uint32 inPos;      ///< position of the next compressed byte in the wrapped stream
+		int bits;          ///< number of bits of the byte before inPos still to be used
+		uint windowSize;
+		byte *window;      ///< last windowSize bytes of output before outPos
 	};
 
 	byte	_buf[BUFSIZE];
@@ -165,36 +209,151 @@ protected:
 	uint32 _origSize;
 	bool _eos;
 
+	/** windowBits parameter to (re)start decompression at the beginning */
+	int _windowBits;
+
+	Array<Checkpoint> _checkpoints;
+	uint32 _checkpointInterval;
+
+	void addCheckpoint(uint32 outPos) {
+#ifdef USE_INFLATE_CHECKPOINTS
+		if (_checkpoints.size() == MAX_CHECKPOINTS) {
+			// Keep the checkpoints evenly spread by dropping every other
+			// one, instead of only covering the start of the stream.
+			uint kept = 0;
+			for (uint i = 0; i < _checkpoints.size(); ++i) {
+				if (i & 1)
+					free(_checkpoints[i].window);
+				else
+					_checkpoints[kept++] = _checkpoints[i];
+			}
+			_checkpoints.resize(kept);
+			_checkpointInterval *= 2;
+
+			if (outPos < _checkpoints.back().outPos + _checkpointInterval)
+				return;
+		}
+
+		Checkpoint checkpoint;
+		checkpoint.outPos = outPos;
+		checkpoint.inPos = _wrapped->pos() - _stream.avail_in;
+		checkpoint.bits = _stream.data_type & 7;
+		checkpoint.window = (byte *)malloc(WINDOWSIZE);
+		if (!checkpoint.window)
+			return;
+
+		uInt windowSize = WINDOWSIZE;
+		if (inflateGetDictionary(&_stream, checkpoint.window, &windowSize) != Z_OK) {
+			free(checkpoint.window);
+			return;
+		}
+		checkpoint.windowSize = windowSize;
+
+		_checkpoints.push_back(checkpoint);
+#endif
+	}
+
+	/**
+	 * Find the last checkpoint at or before the given position.
+	 *
+	 * @return the index of the checkpoint, or -1 if there is none
+	 */
+	int findCheckpoint(uint32 pos) const {
+		int found = -1;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i].outPos <= pos; ++i)
+			found = i;
+		return found;
+	}
+
+	/**
+	 * Restart decompression at the given checkpoint, or at the very start if
+	 * index is -1.
+	 */
+	bool restart(int index) {
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+
+		if (index < 0) {
+			_pos = 0;
+			_wrapped->seek(0, SEEK_SET);
+#ifdef USE_INFLATE_CHECKPOINTS
+			// Restoring a checkpoint may have switched to raw deflate mode
+			_zlibErr = inflateReset2(&_stream, _windowBits);
+#else
+			_zlibErr = inflateReset(&_stream);
+#endif
+			return _zlibErr == Z_OK;
+		}
+
+#ifdef USE_INFLATE_CHECKPOINTS
+		const Checkpoint &checkpoint = _checkpoints[index];
+
+		// Checkpoints are inside the deflate data, after any header
+		_zlibErr = inflateReset2(&_stream, -MAX_WBITS);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		if (checkpoint.bits) {
+			_wrapped->seek(checkpoint.inPos - 1, SEEK_SET);
+			const byte partial = _wrapped->readByte();
+			_zlibErr = inflatePrime(&_stream, checkpoint.bits, partial >> (8 - checkpoint.bits));
+		} else {
+			_wrapped->seek(checkpoint.inPos, SEEK_SET);
+		}
+
+		if (_zlibErr == Z_OK)
+			_zlibErr = inflateSetDictionary(&_stream, checkpoint.window, checkpoint.windowSize);
+
+		_pos = checkpoint.outPos;
+		return _zlibErr == Z_OK;
+#else
+		return false;
+#endif
+	}
+
 public:
 
-	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream() {
+	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0, bool rawDeflate = false, uint32 checkpointInterval = 0)
+		: _wrapped(w), _stream(), _checkpointInterval(checkpointInterval) {
 		assert(w != nullptr);
 
-		// Verify file header is correct
-		w->seek(0, SEEK_SET);
-		uint16 header = w->readUint16BE();
-		assert(header == 0x1F8B ||
-		       ((header & 0x0F00) == 0x0800 && header % 31 == 0));
-
-		if (header == 0x1F8B) {
-			// Retrieve the original file size
-			w->seek(-4, SEEK_END);
-			_origSize = w->readUint32LE();
-		} else {
-			// Original size not available in zlib format
-			// use an otherwise known size if supplied.
+		if (rawDeflate) {
+			// There is no header; the size has to be known
 			_origSize = knownSize;
+			_windowBits = -MAX_WBITS;
+		} else {
+			// Verify file header is correct
+			w->seek(0, SEEK_SET);
+			uint16 header = w->readUint16BE();
+			assert(header == 0x1F8B ||
+			       ((header & 0x0F00) == 0x0800 && header % 31 == 0));
+
+			if (header == 0x1F8B) {
+				// Retrieve the original file size
+				w->seek(-4, SEEK_END);
+				_origSize = w->readUint32LE();
+			} else {
+				// Original size not available in zlib format
+				// use an otherwise known size if supplied.
+				_origSize = knownSize;
+			}
+
+			// Adding 32 to windowBits indicates to zlib that it is supposed to
+			// automatically detect whether gzip or zlib headers are used for
+			// the compressed file. This feature was added in zlib 1.2.0.4,
+			// released 10 August 2003.
+			// Note: This is *crucial* for savegame compatibility, do *not* remove!
+			_windowBits = MAX_WBITS + 32;
 		}
 		_pos = 0;
 		w->seek(0, SEEK_SET);
 		_eos = false;
 
-		// Adding 32 to windowBits indicates to zlib that it is supposed to
-		// automatically detect whether gzip or zlib headers are used for
-		// the compressed file. This feature was added in zlib 1.2.0.4,
-		// released 10 August 2003.
-		// Note: This is *crucial* for savegame compatibility, do *not* remove!
-		_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+#ifndef USE_INFLATE_CHECKPOINTS
+		_checkpointInterval = 0;
+#endif
+
+		_zlibErr = inflateInit2(&_stream, _windowBits);
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -205,6 +364,9 @@ public:
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+
+		for (uint i = 0; i < _checkpoints.size(); ++i)
+			free(_checkpoints[i].window);
 	}
 
 	bool err() const { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -224,6 +386,30 @@ public:
 				_stream.next_in = _buf;
 				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
 			}
+
+#ifdef USE_INFLATE_CHECKPOINTS
+			if (_checkpointInterval) {
+				const uint32 outPos = _pos + dataSize - _stream.avail_out;
+				const uint32 nextPos = (_checkpoints.empty() ? 0 : _checkpoints.back().outPos) + _checkpointInterval;
+
+				if (outPos < nextPos) {
+					// Decompress in one go up to where the next checkpoint is due
+					const uInt availOut = _stream.avail_out;
+					const uInt limit = MIN<uint32>(availOut, nextPos - outPos);
+					_stream.avail_out = limit;
+					_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+					_stream.avail_out += availOut - limit;
+				} else {
+					// Then stop at the next deflate block boundary, which are
+					// the only places decompression can be resumed from.
+					_zlibErr = inflate(&_stream, Z_BLOCK);
+					if (_zlibErr == Z_OK && (_stream.data_type & 128) && !(_stream.data_type & 64))
+						addCheckpoint(_pos + dataSize - _stream.avail_out);
+				}
+				continue;
+			}
+#endif
+
 			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
 		}
 
@@ -262,13 +448,19 @@ public:
 
 		assert(newPos >= 0);
 
-		if ((uint32)newPos < _pos) {
-			// To search backward, we have to restart the whole decompression
-			// from the start of the file. A rather wasteful operation, best
-			// to avoid it. :/
+		const int checkpoint = findCheckpoint(newPos);
+
+		if (checkpoint >= 0 && _checkpoints[checkpoint].outPos > _pos) {
+			// Jump ahead, instead of decompressing everything in between
+			if (!restart(checkpoint))
+				return false;
+		} else if ((uint32)newPos < _pos) {
+			// To search backward, we have to restart the decompression
+			// from the last checkpoint before the target, or from the start
+			// of the file. A rather wasteful operation, best to avoid it. :/
 
 #ifndef RELEASE_BUILD
-			if (!_shownBackwardSeekingWarning) {
+			if (checkpoint < 0 && !_shownBackwardSeekingWarning) {
 				// We only throw this warning once per stream, to avoid
 				// getting the console swarmed with warnings when consecutive
 				// seeks are made.
@@ -277,13 +469,8 @@ public:
 			}
 #endif
 
-			_pos = 0;
-			_wrapped->seek(0, SEEK_SET);
-			_zlibErr = inflateReset(&_stream);
-			if (_zlibErr != Z_OK)
+			if (!restart(checkpoint))
 				return false; // FIXME: STREAM REWRITE
-			_stream.next_in = _buf;
-			_stream.avail_in = 0;
 		}
 
 		offset = newPos - _pos;
@@ -422,7 +609,8 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 		toBeWrapped->seek(-2, SEEK_CUR);
 		if (isCompressed) {
 #if defined(USE_ZLIB)
-			return new GZipReadStream(toBeWrapped, knownSize);
+			const bool seekIndex = toBeWrapped->size() >= GZIP_CHECKPOINT_MIN_SIZE;
+			return new GZipReadStream(toBeWrapped, knownSize, false, seekIndex ? GZIP_CHECKPOINT_INTERVAL : 0);
 #else
 			delete toBeWrapped;
 			return NULL;
@@ -432,6 +620,18 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 	return toBeWrapped;
 }
 
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize, bool seekIndex) {
+	if (toBeWrapped) {
+#if defined(USE_ZLIB)
+		return new GZipReadStream(toBeWrapped, knownSize, true, seekIndex ? DEFLATE_CHECKPOINT_INTERVAL : 0);
+#else
+		delete toBeWrapped;
+		return NULL;
+#endif
+	}
+	return toBeWrapped;
+}
+
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
 #if defined(USE_ZLIB)
 	if (toBeWrapped)
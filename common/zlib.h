@@ -113,6 +113,11 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
  * here. knownSize will be ignored if the GZip-stream DOES include a length.
  * The created stream also becomes responsible for freeing the passed stream.
  *
+ * For compressed data of 256 KiB or more, the wrapper records a bounded
+ * number of points from which decompression can be resumed while data is
+ * read, so that seeking backward does not require decompressing the whole
+ * stream again from the start. This costs up to 256 KiB of memory.
+ *
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
  *
@@ -121,6 +126,27 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
  */
 SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize = 0);
 
+/**
+ * Take an arbitrary SeekableReadStream and wrap it in a custom stream which
+ * provides transparent on-the-fly decompression. Assumes the data it
+ * retrieves from the wrapped stream to be raw deflate data, without any
+ * header, as used e.g. in ZIP archives. If there is no ZLIB support, NULL
+ * is returned and the stream is destroyed.
+ *
+ * The created stream becomes responsible for freeing the passed stream.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ *
+ * @param toBeWrapped	the stream containing the deflate data
+ * @param knownSize		the size of the decompressed data
+ * @param seekIndex		if true, the stream remembers the decompressor state
+ *						at some positions while reading, so seeking backwards
+ *						does not have to restart decompression at the start.
+ *						This costs up to 256 KiB of memory.
+ */
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize, bool seekIndex = false);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which provides
  * transparent on-the-fly compression. The compressed data is written in the
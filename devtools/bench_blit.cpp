@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Times TransparentSurface::blit for every blend mode and alpha type, with
+// and without color modulation, as Wintermute and Sword25 use it for their
+// sprites, and the bilinear scaling of zoomed sprites.
+//
+// Build with "make devtools/bench_blit" from a configured build tree.
+
+// Allow clock() and printf()
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "graphics/transparent_surface.h"
+
+#include <stdio.h>
+#include <time.h>
+
+static const int kSpriteSize = 256;
+static const int kBlits = 500;
+
+static const char *const blendModeNames[] = { "normal", "additive", "subtractive", "multiply" };
+static const char *const alphaTypeNames[] = { "opaque", "binary", "full" };
+
+int main(int argc, char *argv[]) {
+	const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+	Graphics::TransparentSurface sprite;
+	sprite.create(kSpriteSize, kSpriteSize, format);
+	uint32 seed = 1;
+	for (int y = 0; y < kSpriteSize; y++) {
+		uint32 *pixel = (uint32 *)sprite.getBasePtr(0, y);
+		for (int x = 0; x < kSpriteSize; x++) {
+			seed = seed * 1103515245 + 12345;
+			// A round sprite with a soft edge, over a transparent background
+			int dx = x - kSpriteSize / 2, dy = y - kSpriteSize / 2;
+			int alpha = CLIP<int>(255 - (dx * dx + dy * dy) / 64, 0, 255);
+			pixel[x] = (seed & 0xFFFFFF00) | alpha;
+		}
+	}
+
+	Graphics::TransparentSurface target;
+	target.create(640, 480, format);
+	memset(target.getPixels(), 0x80, target.pitch * target.h);
+
+	const Graphics::TSpriteBlendMode blendModes[] = {
+		Graphics::BLEND_NORMAL, Graphics::BLEND_ADDITIVE, Graphics::BLEND_SUBTRACTIVE, Graphics::BLEND_MULTIPLY
+	};
+	const Graphics::AlphaType alphaTypes[] = {
+		Graphics::ALPHA_OPAQUE, Graphics::ALPHA_BINARY, Graphics::ALPHA_FULL
+	};
+	const uint32 colors[] = { 0xFFFFFFFF, 0xC080FF40 };
+
+	printf("%-12s %-7s %10s %10s\n", "blend mode", "alpha", "plain", "color mod");
+	for (int m = 0; m < ARRAYSIZE(blendModes); m++) {
+		for (int a = 0; a < ARRAYSIZE(alphaTypes); a++) {
+			sprite.setAlphaMode(alphaTypes[a]);
+			printf("%-12s %-7s", blendModeNames[m], alphaTypeNames[a]);
+
+			for (int c = 0; c < ARRAYSIZE(colors); c++) {
+				clock_t start = clock();
+				for (int i = 0; i < kBlits; i++)
+					sprite.blit(target, (i * 37) % (640 - kSpriteSize), (i * 23) % (480 - kSpriteSize), Graphics::FLIP_NONE, nullptr, colors[c], -1, -1, blendModes[m]);
+				double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+				printf(" %6.2f ns/px", seconds * 1e9 / ((double)kBlits * kSpriteSize * kSpriteSize));
+			}
+			printf("\n");
+		}
+	}
+
+	printf("\n%-20s %10s\n", "bilinear scale", "time");
+	const int zooms[] = { 50, 90, 110, 200 };
+	for (int z = 0; z < ARRAYSIZE(zooms); z++) {
+		const uint16 size = kSpriteSize * zooms[z] / 100;
+		clock_t start = clock();
+		for (int i = 0; i < kBlits / 10; i++) {
+			Graphics::TransparentSurface *scaled = sprite.scaleT<Graphics::FILTER_BILINEAR>(size, size);
+			scaled->free();
+			delete scaled;
+		}
+		double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+		printf("%3d%% (%3dx%-3d)        %6.2f ns/px\n", zooms[z], size, size, seconds * 1e9 / ((double)(kBlits / 10) * size * size));
+	}
+
+	sprite.free();
+	target.free();
+	return 0;
+}
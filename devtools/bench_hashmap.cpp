@@ -0,0 +1,285 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Compares Common::HashMap and Common::FlatHashMap on the key types that
+// matter most to us: case-insensitive file names (SearchSet, ConfigManager),
+// pointers and small integers (SCI's script and segment tables). It also
+// compares the way FSDirectory used to look up 8.3 file names in its cache
+// with the atom keyed lookup it uses now, and times FSDirectory::hasFile() on
+// the files of a real directory, given on the command line or the current
+// directory otherwise.
+//
+// Build with "make devtools/bench_hashmap" from a configured build tree.
+
+// Allow clock() and printf()
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/atom.h"
+#include "common/archive.h"
+#include "common/flathashmap.h"
+#include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/system.h"
+
+#ifdef POSIX
+#include "backends/fs/posix/posix-fs-factory.h"
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+struct PointerHash {
+	uint operator()(const void *ptr) const { return (uint)((size_t)ptr >> 4); }
+};
+
+static const int kKeyCount = 20000;
+static const int kRounds = 50;
+
+template<class Map, class Key>
+static double benchLookup(const Key *keys, const Key *missing, int count) {
+	Map map;
+	for (int i = 0; i < count; i++)
+		map[keys[i]] = i;
+
+	clock_t start = clock();
+	int found = 0;
+	for (int round = 0; round < kRounds; round++) {
+		for (int i = 0; i < count; i++) {
+			found += map.contains(keys[i]);
+			found += map.contains(missing[i]);
+		}
+	}
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	if (found != count * kRounds)
+		printf("  unexpected result: %d\n", found);
+	return seconds * 1e9 / (2.0 * count * kRounds);
+}
+
+template<class Map, class Key>
+static double benchInsert(const Key *keys, int count) {
+	clock_t start = clock();
+	for (int round = 0; round < kRounds; round++) {
+		Map map;
+		for (int i = 0; i < count; i++)
+			map[keys[i]] = i;
+	}
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	return seconds * 1e9 / ((double)count * kRounds);
+}
+
+template<class Key, class Hash, class Equal>
+static void bench(const char *name, const Key *keys, const Key *missing) {
+	typedef Common::HashMap<Key, int, Hash, Equal> Old;
+	typedef Common::FlatHashMap<Key, int, Hash, Equal> New;
+
+	printf("%s\n", name);
+	printf("  lookup: HashMap %6.1f ns, FlatHashMap %6.1f ns\n",
+		benchLookup<Old>(keys, missing, kKeyCount), benchLookup<New>(keys, missing, kKeyCount));
+	printf("  insert: HashMap %6.1f ns, FlatHashMap %6.1f ns\n",
+		benchInsert<Old>(keys, kKeyCount), benchInsert<New>(keys, kKeyCount));
+}
+
+static double benchStringCache(const Common::String *names, int count) {
+	typedef Common::HashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> Cache;
+	Cache cache;
+	for (int i = 0; i < count; i += 2)
+		cache[names[i]] = i;
+
+	clock_t start = clock();
+	int found = 0;
+	for (int round = 0; round < kRounds; round++) {
+		for (int i = 0; i < count; i++) {
+			// What FSDirectory::lookupCache did before
+			if (cache.contains(names[i]))
+				found += cache[names[i]] >= 0;
+		}
+	}
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	if (found != count / 2 * kRounds)
+		printf("  unexpected result: %d\n", found);
+	return seconds * 1e9 / ((double)count * kRounds);
+}
+
+static double benchAtomCache(const Common::String *names, int count) {
+	typedef Common::HashMap<Common::Atom, int> Cache;
+	Cache cache;
+	for (int i = 0; i < count; i += 2)
+		cache[Common::Atom(names[i])] = i;
+
+	clock_t start = clock();
+	int found = 0;
+	for (int round = 0; round < kRounds; round++) {
+		for (int i = 0; i < count; i++) {
+			const Common::Atom *key = Common::Atom::find(names[i]);
+			if (!key)
+				continue;
+			Cache::const_iterator it = cache.find(*key);
+			if (it != cache.end())
+				found += it->_value >= 0;
+		}
+	}
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	if (found != count / 2 * kRounds)
+		printf("  unexpected result: %d\n", found);
+	return seconds * 1e9 / ((double)count * kRounds);
+}
+
+#ifdef POSIX
+// FSDirectory gets its nodes from the file system factory of g_system
+class BenchSystem : public OSystem {
+public:
+	BenchSystem() { _fsFactory = new POSIXFilesystemFactory(); }
+	~BenchSystem() {}
+
+	const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int) { return true; }
+	int getGraphicsMode() const { return 0; }
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat(); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	void initSize(uint, uint, const Graphics::PixelFormat *) {}
+	int16 getHeight() { return 0; }
+	int16 getWidth() { return 0; }
+	PaletteManager *getPaletteManager() { return 0; }
+	void copyRectToScreen(const void *, int, int, int, int, int) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32) {}
+	void updateScreen() {}
+	void setShakePos(int, int) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(); }
+	void clearOverlay() {}
+	void grabOverlay(void *, int) {}
+	void copyRectToOverlay(const void *, int, int, int, int, int) {}
+	int16 getOverlayHeight() { return 0; }
+	int16 getOverlayWidth() { return 0; }
+	bool showMouse(bool) { return false; }
+	void warpMouse(int, int) {}
+	void setMouseCursor(const void *, uint, uint, int, int, uint32, bool, const Graphics::PixelFormat *) {}
+	uint32 getMillis(bool) { return 0; }
+	void delayMillis(uint) {}
+	void getTimeAndDate(TimeDate &) const {}
+	MutexRef createMutex() { return 0; }
+	void lockMutex(MutexRef) {}
+	void unlockMutex(MutexRef) {}
+	void deleteMutex(MutexRef) {}
+	Audio::Mixer *getMixer() { return 0; }
+	void quit() {}
+	void displayMessageOnOSD(const char *) {}
+	void displayActivityIconOnOSD(const Graphics::Surface *) {}
+	void logMessage(LogMessageType::Type, const char *message) { fputs(message, stderr); }
+};
+
+static void benchDirectory(const char *path) {
+	BenchSystem *system = new BenchSystem();
+	g_system = system;
+
+	{
+		Common::FSDirectory dir((Common::FSNode(path)));
+		Common::ArchiveMemberList members;
+		dir.listMembers(members);
+
+		// Every file in its original spelling and upper case, and as many
+		// missing names, like File::open() probing for alternatives
+		Common::Array<Common::String> names;
+		for (Common::ArchiveMemberList::const_iterator it = members.begin(); it != members.end(); ++it) {
+			const Common::String name = (*it)->getName();
+			Common::String upper = name;
+			upper.toUppercase();
+			names.push_back(name);
+			names.push_back(upper);
+			names.push_back(name + ".bak");
+			names.push_back(upper + ".BAK");
+		}
+
+		if (names.empty()) {
+			printf("FSDirectory: no files in %s\n", path);
+		} else {
+			clock_t start = clock();
+			uint found = 0;
+			for (int round = 0; round < kRounds; round++) {
+				for (uint i = 0; i < names.size(); i++)
+					found += dir.hasFile(names[i]);
+			}
+			double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+			if (found != names.size() / 2 * kRounds)
+				printf("  unexpected result: %u\n", found);
+			printf("FSDirectory with %d files, half of the names missing\n", members.size());
+			printf("  hasFile: %6.1f ns\n", seconds * 1e9 / ((double)names.size() * kRounds));
+		}
+	}
+
+	g_system = nullptr;
+	delete system;
+}
+#endif
+
+int main(int argc, char *argv[]) {
+	Common::String *names = new Common::String[kKeyCount];
+	Common::String *missingNames = new Common::String[kKeyCount];
+	const void **pointers = new const void *[kKeyCount];
+	const void **missingPointers = new const void *[kKeyCount];
+	int *numbers = new int[kKeyCount];
+	int *missingNumbers = new int[kKeyCount];
+
+	byte *block = new byte[kKeyCount * 2 * 32];
+	for (int i = 0; i < kKeyCount; i++) {
+		names[i] = Common::String::format("resource.%03d/Patch%05d.HEP", i % 1000, i);
+		missingNames[i] = Common::String::format("resource.%03d/Patch%05d.SCR", i % 1000, i);
+		pointers[i] = block + i * 2 * 32;
+		missingPointers[i] = block + (i * 2 + 1) * 32;
+		numbers[i] = i;
+		missingNumbers[i] = i + kKeyCount;
+	}
+
+	bench<Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>("case-insensitive file names", names, missingNames);
+
+	// Half of them cached, as with File::exists() probing for alternatives
+	Common::String *shortNames = new Common::String[kKeyCount];
+	for (int i = 0; i < kKeyCount; i++)
+		shortNames[i] = Common::String::format("%s%04d.%s", (i & 2) ? "SOUND" : "VIEW", i / 4, (i & 1) ? "BAK" : "DAT");
+	printf("8.3 file names, half of them cached\n");
+	printf("  lookup: String keys %6.1f ns, Atom keys %6.1f ns\n",
+		benchStringCache(shortNames, kKeyCount), benchAtomCache(shortNames, kKeyCount));
+	delete[] shortNames;
+	bench<const void *, PointerHash, Common::EqualTo<const void *> >("pointers", pointers, missingPointers);
+	bench<int, Common::Hash<int>, Common::EqualTo<int> >("consecutive integers", numbers, missingNumbers);
+#ifdef POSIX
+	benchDirectory(argc > 1 ? argv[1] : ".");
+#endif
+
+	delete[] block;
+	delete[] names;
+	delete[] missingNames;
+	delete[] pointers;
+	delete[] missingPointers;
+	delete[] numbers;
+	delete[] missingNumbers;
+	return 0;
+}
@@ -44,6 +44,15 @@ devtools/make-scumm-fontdata$(EXEEXT): $(srcdir)/devtools/make-scumm-fontdata.c
 	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
 	$(QUIET_LINK)$(LD) $(CFLAGS) -Wall -o $@ $<
 
+# Not part of DEVTOOLS, since they need the libraries of the build tree
+devtools/bench_hashmap$(EXEEXT): $(srcdir)/devtools/bench_hashmap.cpp backends/libbackends.a common/libcommon.a
+	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
+	$(QUIET_LINK)$(CXX) $(CXXFLAGS) $(CPPFLAGS) -o $@ $+
+
+devtools/bench_blit$(EXEEXT): $(srcdir)/devtools/bench_blit.cpp graphics/libgraphics.a common/libcommon.a
+	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
+	$(QUIET_LINK)$(CXX) $(CXXFLAGS) $(CPPFLAGS) -o $@ $+
+
 # Rule to explicitly rebuild the wwwroot archive
 wwwroot:
 	$(srcdir)/devtools/make-www-archive.py $(srcdir)/dists/networking/
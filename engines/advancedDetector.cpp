@@ -33,6 +33,54 @@
 #include "engines/advancedDetector.h"
 #include "engines/obsolete.h"
 
+struct FilePropertiesCache;
+static FilePropertiesCache *s_filePropertiesCache = nullptr;
+
+/**
+ * Sizes and MD5s of the files examined by getFileProperties(), keyed by path,
+ * and shared among all engines during a detection run. This avoids reading
+ * the same files over and over again when every engine is asked to detect
+ * the games in a directory. See DetectionCacheScope.
+ */
+struct FilePropertiesCache : public DetectionCache {
+	typedef Common::HashMap<Common::String, FileProperties> FileMap;
+	FileMap _files;
+
+	~FilePropertiesCache() { s_filePropertiesCache = nullptr; }
+};
+
+/**
+ * Look up the properties of a file in the cache.
+ *
+ * @return true if the file was already examined. Files which could not be
+ *         opened are recorded with a negative size.
+ */
+static bool getCachedFileProperties(const Common::String &key, FileProperties &fileProps) {
+	if (!s_filePropertiesCache)
+		return false;
+
+	FilePropertiesCache::FileMap::const_iterator i = s_filePropertiesCache->_files.find(key);
+	if (i == s_filePropertiesCache->_files.end())
+		return false;
+
+	fileProps = i->_value;
+	return true;
+}
+
+static void cacheFileProperties(const Common::String &key, const FileProperties &fileProps) {
+	if (!s_filePropertiesCache) {
+		FilePropertiesCache *cache = new FilePropertiesCache();
+		if (!DetectionCacheScope::addCache(cache)) {
+			// Outside of a detection run, the files may change at any time
+			delete cache;
+			return;
+		}
+		s_filePropertiesCache = cache;
+	}
+
+	s_filePropertiesCache->_files[key] = fileProps;
+}
+
 static Common::String sanitizeName(const char *name) {
 	Common::String res;
 
@@ -341,7 +389,7 @@ void AdvancedMetaEngine::composeFileHashMap(FileMap &allFiles, const Common::FSL
 			if (!matched)
 				continue;
 
-			if (!file->getChildren(files, Common::FSNode::kListAll))
+			if (!Common::FSDirectory::listDirectory(*file, files))
 				continue;
 
 			composeFileHashMap(allFiles, files, depth - 1, tstr);
@@ -359,14 +407,28 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	// FIXME/TODO: We don't handle the case that a file is listed as a regular
 	// file and as one with resource fork.
 
+	// The MD5 depends on how much of the file is read, which differs
+	// between engines.
+	const Common::String md5Bytes = Common::String::format(":%u", _md5Bytes);
+
 	if (game.flags & ADGF_MACRESFORK) {
-		Common::MacResManager macResMan;
+		const Common::String key = parent.getPath() + "/" + fname + md5Bytes + ":rsrc";
 
-		if (!macResMan.open(parent, fname))
-			return false;
+		if (!getCachedFileProperties(key, fileProps)) {
+			Common::MacResManager macResMan;
 
-		fileProps.md5 = macResMan.computeResForkMD5AsString(_md5Bytes);
-		fileProps.size = macResMan.getResForkDataSize();
+			if (macResMan.open(parent, fname)) {
+				fileProps.md5 = macResMan.computeResForkMD5AsString(_md5Bytes);
+				fileProps.size = macResMan.getResForkDataSize();
+			} else {
+				fileProps = FileProperties();
+			}
+
+			cacheFileProperties(key, fileProps);
+		}
+
+		if (fileProps.size < 0)
+			return false;
 
 		if (fileProps.size != 0)
 			return true;
@@ -375,13 +437,22 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	if (!allFiles.contains(fname))
 		return false;
 
+	const Common::FSNode &node = allFiles[fname];
+	const Common::String key = node.getPath() + md5Bytes;
+
+	if (getCachedFileProperties(key, fileProps))
+		return fileProps.size >= 0;
+
 	Common::File testFile;
 
-	if (!testFile.open(allFiles[fname]))
+	if (!testFile.open(node)) {
+		cacheFileProperties(key, FileProperties());
 		return false;
+	}
 
 	fileProps.size = (int32)testFile.size();
 	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
+	cacheFileProperties(key, fileProps);
 	return true;
 }
 
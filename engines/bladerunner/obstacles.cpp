@@ -44,6 +44,10 @@ Obstacles::Obstacles(BladeRunnerEngine *vm) {
 	_polygons       = new Polygon[kPolygonCount];
 	_polygonsBackup = new Polygon[kPolygonCount];
 	_path           = new Vector2[kVertexCount];
+	_pathCache      = new PathCacheEntry[kPathCacheSize];
+	_pathCacheNext  = 0;
+	_nextPolygonsId = 0;
+	_backupId       = ++_nextPolygonsId;
 	clear();
 }
 
@@ -58,6 +62,9 @@ Obstacles::~Obstacles() {
 
 	delete[] _path;
 	_path = nullptr;
+
+	delete[] _pathCache;
+	_pathCache = nullptr;
 }
 
 void Obstacles::clear() {
@@ -72,6 +79,10 @@ void Obstacles::clear() {
 	_pathSize = 0;
 	_backup = false;
 	_count = 0;
+
+	_polygonsId = ++_nextPolygonsId;
+	_addedRects.clear();
+	forgetFailedMerges();
 }
 
 #define IN_RANGE(v, start, end) ((start) <= (v) && (v) <= (end))
@@ -108,10 +119,29 @@ bool Obstacles::lineLineIntersection(LineSegment a, LineSegment b, Vector2 *inte
 	return false;
 }
 
+/*
+ * Vertices of a polygon never lie outside of its rectangle, so a line
+ * which misses the rectangle can't intersect any of the polygon's edges.
+ * The margin keeps rounding errors in lineIntersection() from making
+ * this skip an intersection.
+ */
+bool Obstacles::lineNearPolygon(Vector2 from, Vector2 to, const Polygon &poly) {
+	const float margin = 1.0f;
+
+	return MIN(from.x, to.x) <= poly.rect.x1 + margin
+	    && MAX(from.x, to.x) >= poly.rect.x0 - margin
+	    && MIN(from.y, to.y) <= poly.rect.y1 + margin
+	    && MAX(from.y, to.y) >= poly.rect.y0 - margin;
+}
+
 bool Obstacles::linePolygonIntersection(LineSegment lineA, VertexType lineAType, Polygon *polyB, Vector2 *intersectionPoint, int *intersectionIndex, int pathLengthSinceLastIntersection) {
 	bool hasIntersection = false;
 	float nearestIntersectionDistance = 0.0f;
 
+	if (!lineNearPolygon(lineA.start, lineA.end, *polyB)) {
+		return false;
+	}
+
 	for (int i = 0; i != polyB->verticeCount; ++i) {
 		LineSegment lineB;
 		lineB.start = polyB->vertices[i];
@@ -265,12 +295,29 @@ bool Obstacles::mergePolygons(Polygon &polyA, Polygon &polyB) {
 	return flagDidMergePolygons;
 }
 
+void Obstacles::forgetFailedMerges() {
+	for (int i = 0; i < kPolygonCount; ++i) {
+		for (int j = 0; j < kPolygonCount; ++j) {
+			_mergeFailed[i][j] = false;
+		}
+	}
+}
+
+void Obstacles::forgetFailedMerges(int polygonIndex) {
+	for (int i = 0; i < kPolygonCount; ++i) {
+		_mergeFailed[i][polygonIndex] = false;
+		_mergeFailed[polygonIndex][i] = false;
+	}
+}
+
 void Obstacles::add(RectFloat rect) {
 	int polygonIndex = findEmptyPolygon();
 	if (polygonIndex < 0) {
 		return;
 	}
 
+	_addedRects.push_back(rect);
+
 	rect.expand(12.0f);
 	rect.trunc_2_decimals();
 
@@ -293,6 +340,8 @@ void Obstacles::add(RectFloat rect) {
 	poly.isPresent = true;
 	poly.verticeCount = 4;
 
+	forgetFailedMerges(polygonIndex);
+
 restart:
 	for (int i = 0; i < kPolygonCount; ++i) {
 		Polygon &polyA = _polygons[i];
@@ -318,9 +367,18 @@ restart:
 				continue;
 			}
 
+			// Merging is deterministic, so unchanged pairs which failed before would fail again
+			if (_mergeFailed[i][j]) {
+				continue;
+			}
+
 			if (mergePolygons(polyA, polyB)) {
+				forgetFailedMerges(i);
+				forgetFailedMerges(j);
 				goto restart;
 			}
+
+			_mergeFailed[i][j] = true;
 		}
 	}
 }
@@ -350,6 +408,53 @@ bool Obstacles::findNextWaypoint(const Vector3 &from, const Vector3 &to, Vector3
 #else
 
 bool Obstacles::findNextWaypoint(const Vector3 &from, const Vector3 &to, Vector3 *next) {
+	int sceneId = _vm->_scene->getSceneId();
+	int setId = _vm->_scene->getSetId();
+
+	for (int i = 0; i != kPathCacheSize; ++i) {
+		PathCacheEntry &entry = _pathCache[i];
+		if (!entry.isValid
+		 || entry.polygonsId != _polygonsId
+		 || entry.sceneId != sceneId
+		 || entry.setId != setId
+		 || entry.from.x != from.x || entry.from.y != from.y || entry.from.z != from.z
+		 || entry.to.x != to.x || entry.to.y != to.y || entry.to.z != to.z
+		 || entry.addedRects != _addedRects
+		) {
+			continue;
+		}
+
+		for (int j = 0; j != entry.pathSize; ++j) {
+			_path[j] = entry.path[j];
+		}
+		_pathSize = entry.pathSize;
+		*next = entry.next;
+		return entry.result;
+	}
+
+	bool result = findNextWaypointUncached(from, to, next);
+
+	PathCacheEntry &entry = _pathCache[_pathCacheNext];
+	_pathCacheNext = (_pathCacheNext + 1) % kPathCacheSize;
+
+	entry.isValid    = true;
+	entry.sceneId    = sceneId;
+	entry.setId      = setId;
+	entry.polygonsId = _polygonsId;
+	entry.addedRects = _addedRects;
+	entry.from       = from;
+	entry.to         = to;
+	entry.next       = *next;
+	entry.result     = result;
+	entry.pathSize   = _pathSize;
+	for (int j = 0; j != _pathSize; ++j) {
+		entry.path[j] = _path[j];
+	}
+
+	return result;
+}
+
+bool Obstacles::findNextWaypointUncached(const Vector3 &from, const Vector3 &to, Vector3 *next) {
 	static int  recursionLevel = 0;
 	static bool polygonVisited[kPolygonCount];
 
@@ -374,6 +479,10 @@ bool Obstacles::findNextWaypoint(const Vector3 &from, const Vector3 &to, Vector3
 			continue;
 		}
 
+		if (!lineNearPolygon(from.xz(), to.xz(), poly)) {
+			continue;
+		}
+
 		int     nearVertIndex;
 		float   nearDist;
 		Vector2 nearPos;
@@ -447,7 +556,7 @@ bool Obstacles::findNextWaypoint(const Vector3 &from, const Vector3 &to, Vector3
 		}
 		assert(_pathSize > 0);
 		Vector3 lastPathPos(_path[_pathSize - 1].x, from.y, _path[_pathSize - 1].y);
-		findNextWaypoint(lastPathPos, to, next);
+		findNextWaypointUncached(lastPathPos, to, next);
 	}
 
 	if (--recursionLevel > 1) {
@@ -740,6 +849,10 @@ bool Obstacles::findFarthestAvailablePathVertex(Vector2 *path, int pathSize, Vec
 				continue;
 			}
 
+			if (!lineNearPolygon(Vector2(start.x, start.z), path[pathVertexIdx], *polygon)) {
+				continue;
+			}
+
 			for (int polygonVertexIdx = 0; polygonVertexIdx < polygon->verticeCount && pathVertexAvailable; ++polygonVertexIdx) {
 				int polygonVertexNextIdx = (polygonVertexIdx + 1) % polygon->verticeCount;
 
@@ -858,15 +971,29 @@ void Obstacles::backup() {
 
 	_count = count;
 	_backup = true;
+
+	_backupId = ++_nextPolygonsId;
+	_polygonsId = ++_nextPolygonsId;
+	_addedRects.clear();
+	forgetFailedMerges();
 }
 
 void Obstacles::restore() {
+	// Nothing was added since the polygons were last restored
+	if (_polygonsId == _backupId && _addedRects.empty()) {
+		return;
+	}
+
 	for (int i = 0; i != kPolygonCount; ++i) {
 		_polygons[i].isPresent = false;
 	}
 	for (int i = 0; i != kPolygonCount; ++i) {
 		_polygons[i] = _polygonsBackup[i];
 	}
+
+	_polygonsId = _backupId;
+	_addedRects.clear();
+	forgetFailedMerges();
 }
 
 void Obstacles::save(SaveFileWriteStream &f) {
@@ -923,6 +1050,11 @@ void Obstacles::load(SaveFileReadStream &f) {
 		_polygons[i] = _polygonsBackup[i];
 	}
 
+	_backupId = ++_nextPolygonsId;
+	_polygonsId = _backupId;
+	_addedRects.clear();
+	forgetFailedMerges();
+
 	for (int i = 0; i < kVertexCount; ++i) {
 		_path[i] = f.readVector2();
 	}
@@ -26,6 +26,8 @@
 #include "bladerunner/rect_float.h"
 #include "bladerunner/vector.h"
 
+#include "common/array.h"
+
 namespace BladeRunner {
 
 class BladeRunnerEngine;
@@ -37,6 +39,7 @@ class Obstacles {
 	static const int kPolygonCount       =  50;
 	static const int kPolygonVertexCount = 160;
 	static const int kMaxPathSize        = 500;
+	static const int kPathCacheSize      =   8;
 
 	enum VertexType {
 		BOTTOM_LEFT,
@@ -61,6 +64,24 @@ class Obstacles {
 		{}
 	};
 
+	// A findNextWaypoint() result, along with everything it depended on
+	struct PathCacheEntry {
+		bool                     isValid;
+		int                      sceneId;
+		int                      setId;
+		uint                     polygonsId;
+		Common::Array<RectFloat> addedRects;
+		Vector3                  from;
+		Vector3                  to;
+		Vector3                  next;
+		bool                     result;
+		int                      pathSize;
+		Vector2                  path[kVertexCount];
+
+		PathCacheEntry() : isValid(false), sceneId(-1), setId(-1), polygonsId(0), result(false), pathSize(0)
+		{}
+	};
+
 	BladeRunnerEngine *_vm;
 
 	Polygon *_polygons;
@@ -70,10 +91,30 @@ class Obstacles {
 	int      _count;
 	bool     _backup;
 
+	// _polygons are identified by the id of the state they were last reset to,
+	// plus the rectangles that were added since then
+	uint     _nextPolygonsId;
+	uint     _polygonsId;
+	uint     _backupId;
+	Common::Array<RectFloat> _addedRects;
+
+	// Pairs of polygons which mergePolygons() already failed to merge,
+	// and which haven't changed since
+	bool     _mergeFailed[kPolygonCount][kPolygonCount];
+
+	PathCacheEntry *_pathCache;
+	int             _pathCacheNext;
+
 	static bool lineLineIntersection(LineSegment a, LineSegment b, Vector2 *intersectionPoint);
 	static bool linePolygonIntersection(LineSegment lineA, VertexType lineAType, Polygon *polyB, Vector2 *intersectionPoint, int *intersectionIndex, int pathLengthSinceLastIntersection);
 
+	static bool lineNearPolygon(Vector2 from, Vector2 to, const Polygon &poly);
+
 	bool mergePolygons(Polygon &polyA, Polygon &PolyB);
+	void forgetFailedMerges();
+	void forgetFailedMerges(int polygonIndex);
+
+	bool findNextWaypointUncached(const Vector3 &from, const Vector3 &to, Vector3 *next);
 
 public:
 	Obstacles(BladeRunnerEngine *vm);
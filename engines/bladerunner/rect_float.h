@@ -58,6 +58,14 @@ struct RectFloat {
 	}
 };
 
+inline bool operator==(const RectFloat &a, const RectFloat &b) {
+	return a.x0 == b.x0 && a.y0 == b.y0 && a.x1 == b.x1 && a.y1 == b.y1;
+}
+
+inline bool operator!=(const RectFloat &a, const RectFloat &b) {
+	return !(a == b);
+}
+
 inline bool overlaps(const RectFloat &a, const RectFloat &b) {
 	return !(a.y1 < b.y0 || a.y0 > b.y1 || a.x0 > b.x1 || a.x1 < b.x0);
 }
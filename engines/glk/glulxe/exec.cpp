@@ -29,7 +29,7 @@ void Glulxe::execute_loop() {
 	bool done_executing = false;
 	int ix;
 	uint opcode;
-	const operandlist_t *oplist;
+	decodedinst_t *decoded;
 	oparg_t inst[MAX_OPERANDS];
 	uint value, addr, val0, val1;
 	int vals0, vals1;
@@ -49,44 +49,29 @@ void Glulxe::execute_loop() {
 		/* Stash the current opcode's address, in case the interpreter needs to serialize the VM state out-of-band. */
 		prevpc = pc;
 
-		/* Fetch the opcode number. */
-		opcode = Mem1(pc);
-		pc++;
-		if (opcode & 0x80) {
-			/* More than one-byte opcode. */
-			if (opcode & 0x40) {
-				/* Four-byte opcode */
-				opcode &= 0x3F;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
+		/* Fetch the decoded instruction. Code in ROM can't be modified,
+		   so it only needs decoding once; after that it is taken from
+		   the cache, which also moves the PC up to the end of the
+		   instruction. Code in RAM is decoded every time it runs. */
+		if (pc < ramstart) {
+			decoded = &decodecache[pc & (DECODECACHE_SIZE - 1)];
+			if (decoded->addr == pc) {
+				pc = decoded->nextpc;
 			} else {
-				/* Two-byte opcode */
-				opcode &= 0x7F;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
+				decode_instruction(decoded);
+				/* Don't keep an instruction whose operands run on into RAM. */
+				if (decoded->nextpc > ramstart)
+					decoded->addr = DECODECACHE_EMPTY;
 			}
+		} else {
+			decoded = &decodedram;
+			decode_instruction(decoded);
 		}
 
-		/* Now we have an opcode number. */
-
-		/* Fetch the structure that describes how the operands for this
-		   opcode are arranged. This is a pointer to an immutable,
-		   static object. */
-		if (opcode < 0x80)
-			oplist = fast_operandlist[opcode];
-		else
-			oplist = lookup_operandlist(opcode);
-
-		if (!oplist)
-			fatal_error_i("Encountered unknown opcode.", opcode);
-
-		/* Based on the oplist structure, load the actual operand values
-		   into inst. This moves the PC up to the end of the instruction. */
-		parse_operands(inst, oplist);
+		/* Now we have an opcode number. Load the actual operand values
+		   into inst. */
+		opcode = decoded->opcode;
+		load_operands(inst, decoded);
 
 		/* Perform the opcode. This switch statement is split in two, based
 		   on some paranoid suspicions about the ability of compilers to
@@ -143,6 +143,17 @@ private:
 	 */
 	const operandlist_t *fast_operandlist[0x80];
 
+	/**
+	 * Direct-mapped cache of decoded instructions, indexed by the low bits of their address.
+	 * Only instructions which lie wholly in ROM are kept, since ROM can never be written to.
+	 */
+	decodedinst_t *decodecache;
+
+	/**
+	 * Holds the current instruction when it is in RAM, and so can't be cached.
+	 */
+	decodedinst_t decodedram;
+
 	/**@}*/
 
 	/**
@@ -519,10 +530,16 @@ public:
 	 */
 
 	/**
-	 * Set up the fast-lookup array of operandlists. This is called just once, when the terp starts up.
+	 * Set up the fast-lookup array of operandlists and the decoded instruction cache. This is called
+	 * just once, when the terp starts up.
 	 */
 	void init_operands();
 
+	/**
+	 * Clean up the decoded instruction cache when the VM shuts down.
+	 */
+	void final_operands();
+
 	/**
 	 * Return the operandlist for a given opcode. For opcodes in the range 00..7F, it's faster
 	 * to use the array fast_operandlist[].
@@ -530,13 +547,18 @@ public:
 	const operandlist_t *lookup_operandlist(uint opcode);
 
 	/**
-	 * Read the list of operands of an instruction, and put the values in args. This assumes
-	 * that the PC is at the beginning of the operand mode list (right after an opcode number.)
+	 * Read the opcode and operand modes of the instruction at the PC, and put them in inst.
 	 * Upon return, the PC will be at the beginning of the next instruction.
+	 */
+	void decode_instruction(decodedinst_t *inst);
+
+	/**
+	 * Load the values of a decoded instruction's operands into args. This pops any stack
+	 * operands, so it must be done exactly once each time the instruction is executed.
 	 *
 	 * This also assumes that args points at an allocated array of MAX_OPERANDS oparg_t structures.
 	*/
-	void parse_operands(oparg_t *opargs, const operandlist_t *oplist);
+	void load_operands(oparg_t *opargs, const decodedinst_t *inst);
 
 	/**
 	 * Store a result value, according to the desttype and destaddress given. This is usually used to store
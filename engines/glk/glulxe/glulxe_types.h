@@ -352,6 +352,50 @@ typedef oparg_struct oparg_t;
 
 #define MAX_OPERANDS (8)
 
+/**
+ * How a decoded operand gets its value when the instruction is executed. The store kinds
+ * are equal to the desttype values which store_operand() takes.
+ */
+enum decodedarg {
+	decodedarg_Discard = 0,
+	decodedarg_StoreMem = 1,
+	decodedarg_StoreLocal = 2,
+	decodedarg_Push = 3,
+	decodedarg_Const = 4,
+	decodedarg_Pop = 5,
+	decodedarg_LoadMem = 6,
+	decodedarg_LoadLocal = 7
+};
+
+/**
+ * Represents one operand of a decoded instruction. The value is the constant, or the main
+ * memory or locals address, which was read from the instruction's operand bytes.
+ */
+struct decodedarg_struct {
+	uint kind;
+	uint value;
+};
+typedef decodedarg_struct decodedarg_t;
+
+/**
+ * Represents an instruction whose opcode and operand addressing modes have been decoded.
+ * Loading the actual operand values is left until the instruction is executed.
+ */
+struct decodedinst_struct {
+	uint addr;                  ///< Address of the opcode, or DECODECACHE_EMPTY
+	uint nextpc;                ///< Address of the following instruction
+	uint opcode;
+	const operandlist_t *oplist;
+	decodedarg_t args[MAX_OPERANDS];
+};
+typedef decodedinst_struct decodedinst_t;
+
+/**
+ * Number of slots in the decoded instruction cache. This must be a power of two.
+ */
+#define DECODECACHE_SIZE (4096)
+#define DECODECACHE_EMPTY (0xFFFFFFFF)
+
 typedef uint(Glulxe::*acceleration_func)(uint argc, uint *argv);
 
 struct accelentry_struct {
@@ -67,6 +67,21 @@ static const operandlist_t list_LLSS = { 4, 4, &array_LLSS[0] };
 void Glulxe::init_operands() {
 	for (int ix = 0; ix < 0x80; ix++)
 		fast_operandlist[ix] = lookup_operandlist(ix);
+
+	if (!decodecache) {
+		decodecache = (decodedinst_t *)glulx_malloc(DECODECACHE_SIZE * sizeof(decodedinst_t));
+		if (!decodecache)
+			fatal_error("Unable to allocate instruction cache.");
+	}
+	for (int ix = 0; ix < DECODECACHE_SIZE; ix++)
+		decodecache[ix].addr = DECODECACHE_EMPTY;
+}
+
+void Glulxe::final_operands() {
+	if (decodecache) {
+		glulx_free(decodecache);
+		decodecache = nullptr;
+	}
 }
 
 const operandlist_t *Glulxe::lookup_operandlist(uint opcode) {
@@ -280,23 +295,62 @@ const operandlist_t *Glulxe::lookup_operandlist(uint opcode) {
 	}
 }
 
-void Glulxe::parse_operands(oparg_t *args, const operandlist_t *oplist) {
+void Glulxe::decode_instruction(decodedinst_t *inst) {
 	int ix;
-	oparg_t *curarg;
-	int numops = oplist->num_ops;
-	int argsize = oplist->arg_size;
-	uint modeaddr = pc;
+	uint opcode;
+	const operandlist_t *oplist;
+	decodedarg_t *curarg;
+	int numops;
+	uint modeaddr;
 	int modeval = 0;
 
+	inst->addr = pc;
+
+	/* Fetch the opcode number. */
+	opcode = Mem1(pc);
+	pc++;
+	if (opcode & 0x80) {
+		/* More than one-byte opcode. */
+		if (opcode & 0x40) {
+			/* Four-byte opcode */
+			opcode &= 0x3F;
+			opcode = (opcode << 8) | Mem1(pc);
+			pc++;
+			opcode = (opcode << 8) | Mem1(pc);
+			pc++;
+			opcode = (opcode << 8) | Mem1(pc);
+			pc++;
+		} else {
+			/* Two-byte opcode */
+			opcode &= 0x7F;
+			opcode = (opcode << 8) | Mem1(pc);
+			pc++;
+		}
+	}
+
+	/* Fetch the structure that describes how the operands for this
+	   opcode are arranged. This is a pointer to an immutable,
+	   static object. */
+	if (opcode < 0x80)
+		oplist = fast_operandlist[opcode];
+	else
+		oplist = lookup_operandlist(opcode);
+
+	if (!oplist)
+		fatal_error_i("Encountered unknown opcode.", opcode);
+
+	inst->opcode = opcode;
+	inst->oplist = oplist;
+
+	numops = oplist->num_ops;
+	modeaddr = pc;
 	pc += (numops + 1) / 2;
 
-	for (ix = 0, curarg = args; ix < numops; ix++, curarg++) {
+	for (ix = 0, curarg = inst->args; ix < numops; ix++, curarg++) {
 		int mode;
 		uint value;
 		uint addr;
 
-		curarg->desttype = 0;
-
 		if ((ix & 1) == 0) {
 			modeval = Mem1(modeaddr);
 			mode = (modeval & 0x0F);
@@ -310,22 +364,19 @@ void Glulxe::parse_operands(oparg_t *args, const operandlist_t *oplist) {
 			switch (mode) {
 
 			case 8: /* pop off stack */
-				if (stackptr < valstackbase + 4) {
-					fatal_error("Stack underflow in operand.");
-				}
-				stackptr -= 4;
-				value = Stk4(stackptr);
+				curarg->kind = decodedarg_Pop;
+				curarg->value = 0;
 				break;
 
 			case 0: /* constant zero */
 				value = 0;
-				break;
+				goto Constant;
 
 			case 1: /* one-byte constant */
 				/* Sign-extend from 8 bits to 32 */
 				value = (int)(signed char)(Mem1(pc));
 				pc++;
-				break;
+				goto Constant;
 
 			case 2: /* two-byte constant */
 				/* Sign-extend the first byte from 8 bits to 32; the subsequent
@@ -334,12 +385,18 @@ void Glulxe::parse_operands(oparg_t *args, const operandlist_t *oplist) {
 				pc++;
 				value = (value << 8) | (uint)(Mem1(pc));
 				pc++;
-				break;
+				goto Constant;
 
 			case 3: /* four-byte constant */
 				/* Bytes must not be sign-extended. */
 				value = Mem4(pc);
 				pc += 4;
+				/* fall through */
+
+Constant:
+				/* cases 0, 1, 2, 3 all wind up here. */
+				curarg->kind = decodedarg_Const;
+				curarg->value = value;
 				break;
 
 			case 15: /* main memory RAM, four-byte address */
@@ -377,13 +434,8 @@ void Glulxe::parse_operands(oparg_t *args, const operandlist_t *oplist) {
 
 MainMemAddr:
 				/* cases 5, 6, 7, 13, 14, 15 all wind up here. */
-				if (argsize == 4) {
-					value = Mem4(addr);
-				} else if (argsize == 2) {
-					value = Mem2(addr);
-				} else {
-					value = Mem1(addr);
-				}
+				curarg->kind = decodedarg_LoadMem;
+				curarg->value = addr;
 				break;
 
 			case 11: /* locals, four-byte address */
@@ -402,38 +454,28 @@ MainMemAddr:
 				/* fall through */
 
 LocalsAddr:
-				/* cases 9, 10, 11 all wind up here. It's illegal for addr to not
-				   be four-byte aligned, but we don't check this explicitly.
-				   A "strict mode" interpreter probably should. It's also illegal
-				   for addr to be less than zero or greater than the size of
-				   the locals segment. */
-				addr += localsbase;
-				if (argsize == 4) {
-					value = Stk4(addr);
-				} else if (argsize == 2) {
-					value = Stk2(addr);
-				} else {
-					value = Stk1(addr);
-				}
+				/* cases 9, 10, 11 all wind up here. The address is relative
+				   to the locals segment of whichever call frame is current
+				   when the instruction is executed, so localsbase is added
+				   in load_operands(). */
+				curarg->kind = decodedarg_LoadLocal;
+				curarg->value = addr;
 				break;
 
 			default:
-				value = 0;
 				fatal_error("Unknown addressing mode in load operand.");
 			}
 
-			curarg->value = value;
-
 		} else { /* modeform_Store */
 			switch (mode) {
 
 			case 0: /* discard value */
-				curarg->desttype = 0;
+				curarg->kind = decodedarg_Discard;
 				curarg->value = 0;
 				break;
 
 			case 8: /* push on stack */
-				curarg->desttype = 3;
+				curarg->kind = decodedarg_Push;
 				curarg->value = 0;
 				break;
 
@@ -472,7 +514,7 @@ LocalsAddr:
 
 WrMainMemAddr:
 				/* cases 5, 6, 7 all wind up here. */
-				curarg->desttype = 1;
+				curarg->kind = decodedarg_StoreMem;
 				curarg->value = addr;
 				break;
 
@@ -497,7 +539,7 @@ WrLocalsAddr:
 				   A "strict mode" interpreter probably should. It's also illegal
 				   for addr to be less than zero or greater than the size of
 				   the locals segment. */
-				curarg->desttype = 2;
+				curarg->kind = decodedarg_StoreLocal;
 				/* We don't add localsbase here; the store address for desttype 2
 				   is relative to the current locals segment, not an absolute
 				   stack position. */
@@ -515,6 +557,71 @@ WrLocalsAddr:
 			}
 		}
 	}
+
+	inst->nextpc = pc;
+}
+
+void Glulxe::load_operands(oparg_t *args, const decodedinst_t *inst) {
+	int ix;
+	oparg_t *curarg;
+	const decodedarg_t *decarg;
+	int numops = inst->oplist->num_ops;
+	int argsize = inst->oplist->arg_size;
+
+	for (ix = 0, curarg = args, decarg = inst->args; ix < numops; ix++, curarg++, decarg++) {
+		uint addr;
+
+		switch (decarg->kind) {
+
+		case decodedarg_Const:
+			curarg->desttype = 0;
+			curarg->value = decarg->value;
+			break;
+
+		case decodedarg_Pop:
+			if (stackptr < valstackbase + 4) {
+				fatal_error("Stack underflow in operand.");
+			}
+			stackptr -= 4;
+			curarg->desttype = 0;
+			curarg->value = Stk4(stackptr);
+			break;
+
+		case decodedarg_LoadMem:
+			addr = decarg->value;
+			curarg->desttype = 0;
+			if (argsize == 4) {
+				curarg->value = Mem4(addr);
+			} else if (argsize == 2) {
+				curarg->value = Mem2(addr);
+			} else {
+				curarg->value = Mem1(addr);
+			}
+			break;
+
+		case decodedarg_LoadLocal:
+			/* It's illegal for addr to not be four-byte aligned, but we
+			   don't check this explicitly. A "strict mode" interpreter
+			   probably should. It's also illegal for addr to be less than
+			   zero or greater than the size of the locals segment. */
+			addr = decarg->value + localsbase;
+			curarg->desttype = 0;
+			if (argsize == 4) {
+				curarg->value = Stk4(addr);
+			} else if (argsize == 2) {
+				curarg->value = Stk2(addr);
+			} else {
+				curarg->value = Stk1(addr);
+			}
+			break;
+
+		default:
+			/* The store kinds are the same as the desttype values. */
+			curarg->desttype = decarg->kind;
+			curarg->value = decarg->value;
+			break;
+		}
+	}
 }
 
 void Glulxe::store_operand(uint desttype, uint destaddr, uint storeval) {
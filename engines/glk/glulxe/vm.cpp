@@ -116,6 +116,7 @@ void Glulxe::finalize_vm() {
 		stack = nullptr;
 	}
 
+	final_operands();
 	final_serial();
 }
 
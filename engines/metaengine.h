@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/error.h"
 #include "common/array.h"
+#include "common/noncopyable.h"
 
 #include "engines/game.h"
 #include "engines/savestate.h"
@@ -262,6 +263,39 @@ public:
 	//@}
 };
 
+/**
+ * Information meta engines gathered about the files they examined during
+ * detection, to be shared with the other engines; see DetectionCacheScope.
+ */
+class DetectionCache {
+public:
+	virtual ~DetectionCache() {}
+};
+
+/**
+ * While an object of this class exists, meta engines may keep caches of what
+ * they learn about the files they examine, like the MD5s computed by the
+ * advanced detector, and share them among all engines. This avoids reading
+ * the same files over and over again when every engine is asked to detect
+ * the games in a directory.
+ *
+ * The files must not change while the caches are in use, so they are only
+ * kept for the duration of a detection run. Scopes may be nested; the caches
+ * are deleted when the outermost one ends.
+ */
+class DetectionCacheScope : Common::NonCopyable {
+public:
+	DetectionCacheScope();
+	~DetectionCacheScope();
+
+	/**
+	 * Hand a cache over to the current detection run, which deletes it when
+	 * it ends. Returns false, and leaves the cache to the caller, if there is
+	 * no detection run going on.
+	 */
+	static bool addCache(DetectionCache *cache);
+};
+
 /**
  * Singleton class which manages all Engine plugins.
  */
@@ -117,6 +117,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
@@ -338,6 +339,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_types - Shows the valid resource types\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
+	debugPrintf(" resource_cache - Shows statistics about the resource cache, or sets its size\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
@@ -1028,6 +1030,37 @@ bool Console::cmdAllocList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset") && atoi(argv[1]) <= 0)) {
+		debugPrintf("Shows statistics about the resource cache.\n");
+		debugPrintf("Usage: %s [<size in KiB> | reset]\n", argv[0]);
+		debugPrintf("A size sets the amount of memory unlocked resources may use,\n");
+		debugPrintf("'reset' resets the statistics.\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		if (!strcmp(argv[1], "reset"))
+			resMan->resetCacheStats();
+		else
+			resMan->setMaxMemoryLRU(atoi(argv[1]) * 1024);
+	}
+
+	const ResourceCacheStats &stats = resMan->getCacheStats();
+	int lruMemory, lockedMemory;
+	resMan->getCacheMemory(lruMemory, lockedMemory);
+
+	debugPrintf("Cached: %d of %d KiB, locked: %d KiB\n", lruMemory / 1024, resMan->getMaxMemoryLRU() / 1024, lockedMemory / 1024);
+	debugPrintf("Hits: %u, misses: %u", stats.hits, stats.misses);
+	if (stats.hits + stats.misses)
+		debugPrintf(" (%u%% hits)", (uint)((uint64)stats.hits * 100 / (stats.hits + stats.misses)));
+	debugPrintf("\n");
+	debugPrintf("Evicted: %u resources, %u KiB\n", stats.evictions, stats.evictedBytes / 1024);
+	return true;
+}
+
 bool Console::cmdDissectScript(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Examines a script\n");
@@ -345,6 +345,7 @@ static void patchKSaveRestore(SegManager *segMan, reg_t methodAddress, byte id)
 	byte *patchPtr = const_cast<byte *>(script->getBuf(methodAddress.getOffset()));
 	memcpy(patchPtr, kSaveRestorePatch, sizeof(kSaveRestorePatch));
 	patchPtr[8] = id;
+	script->invalidateInstructions();
 }
 
 void GuestAdditions::patchGameSaveRestoreSCI16() const {
@@ -448,6 +449,8 @@ void GuestAdditions::patchGameSaveRestoreTorin(Script &script) const {
 		SWAP(patchPtr[1], patchPtr[2]);
 		SWAP(patchPtr[8], patchPtr[9]);
 	}
+
+	script.invalidateInstructions();
 }
 
 void GuestAdditions::patchGameSaveRestorePhant2(Script &script) const {
@@ -466,6 +469,7 @@ void GuestAdditions::patchGameSaveRestorePhant2(Script &script) const {
 
 		byte *scriptData = const_cast<byte *>(script.getBuf(obj.getFunction(methodIndex).getOffset()));
 		memcpy(scriptData, SRDialogPatch, sizeof(SRDialogPatch));
+		script.invalidateInstructions();
 		break;
 	}
 }
@@ -508,6 +512,7 @@ void GuestAdditions::patchSRDialogDoit(Script &script, const char *const objectN
 					}
 				}
 
+				script.invalidateInstructions();
 				return;
 			}
 		}
@@ -51,6 +51,7 @@
 namespace Sci {
 
 void playVideo(Video::VideoDecoder &videoDecoder) {
+	videoDecoder.setDecodeAhead(4);
 	videoDecoder.start();
 
 	Common::SpanOwner<SciSpan<byte> > scaleBuffer;
@@ -111,7 +112,9 @@ void playVideo(Video::VideoDecoder &videoDecoder) {
 		if (g_sci->getEngineState()->_delayedRestoreGameId != -1)
 			skipVideo = true;
 
-		g_system->delayMillis(10);
+		// Use the time until the next frame to decode the following ones
+		if (!videoDecoder.decodeAhead())
+			g_system->delayMillis(10);
 	}
 }
 
@@ -73,6 +73,25 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	invalidateInstructions();
+}
+
+const PMachineInstruction &Script::decodeInstruction(uint32 offset) {
+	PMachineInstruction instruction;
+	instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.opparams);
+
+	if (_decodedInstructions.size() == 0xFFFF) {
+		// The index is full, which should never happen with real scripts
+		_uncachedInstruction = instruction;
+		return _uncachedInstruction;
+	}
+
+	if (_decodedIndex.empty())
+		_decodedIndex.resize(getBufSize());
+	_decodedInstructions.push_back(instruction);
+	_decodedIndex[offset] = _decodedInstructions.size();
+	return _decodedInstructions.back();
 }
 
 enum {
@@ -69,6 +69,13 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/** A script instruction, as decoded by readPMachineInstruction() */
+struct PMachineInstruction {
+	int16 opparams[4];
+	uint16 size;
+	byte extOpcode;
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -102,6 +109,18 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	/**
+	 * Instructions which have been executed before, in decoded form, so that
+	 * they do not have to be decoded again every time they are executed.
+	 * _decodedIndex maps the offset of an instruction to its index in
+	 * _decodedInstructions plus one, or to 0 if it has not been decoded yet.
+	 */
+	Common::Array<uint16> _decodedIndex;
+	Common::Array<PMachineInstruction> _decodedInstructions;
+	PMachineInstruction _uncachedInstruction;
+
+	const PMachineInstruction &decodeInstruction(uint32 offset);
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -118,6 +137,25 @@ public:
 	}
 
 	const byte *getBuf(uint offset = 0) const { return _buf->getUnsafeDataAt(offset); }
+
+	/**
+	 * Returns the decoded instruction at the given offset. The returned
+	 * reference is only valid until the next call.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset) {
+		if (offset < _decodedIndex.size() && _decodedIndex[offset])
+			return _decodedInstructions[_decodedIndex[offset] - 1];
+		return decodeInstruction(offset);
+	}
+
+	/**
+	 * Forgets all decoded instructions. This needs to be called whenever code
+	 * is patched after the script has been loaded.
+	 */
+	void invalidateInstructions() {
+		_decodedIndex.clear();
+		_decodedInstructions.clear();
+	}
 	SciSpan<const byte> getSpan(uint offset) const { return _buf->subspan(offset); }
 
 	int getScriptNumber() const { return _nr; }
@@ -22,6 +22,7 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
@@ -209,6 +210,9 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
+	_lruPrev = nullptr;
+	_lruNext = nullptr;
+	_reused = false;
 }
 
 Resource::~Resource() {
@@ -222,6 +226,7 @@ void Resource::unalloc() {
 	delete[] _data;
 	_data = nullptr;
 	_status = kResStatusNoMalloc;
+	_reused = false;
 }
 
 void Resource::writeToStream(Common::WriteStream *stream) const {
@@ -972,7 +977,10 @@ void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
-	_LRU.clear();
+	for (int i = 0; i < kLRUListCount; ++i) {
+		_LRU[i].head = _LRU[i].tail = nullptr;
+		_LRU[i].memory = 0;
+	}
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1032,6 +1040,12 @@ void ResourceManager::init() {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
 	}
 
+	if (ConfMan.hasKey("resource_cache")) {
+		const int maxMemory = ConfMan.getInt("resource_cache");
+		if (maxMemory > 0)
+			_maxMemoryLRU = maxMemory * 1024;
+	}
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -1073,12 +1087,42 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+// Fraction of the LRU memory budget which may be taken by resources in the
+// protected LRU list
+#define PROTECTED_LRU_SHARE(x) ((x) / 4 * 3)
+
+void ResourceManager::linkLRU(LRUListType type, Resource *res) {
+	LRUList &list = _LRU[type];
+	res->_lruPrev = nullptr;
+	res->_lruNext = list.head;
+	if (list.head)
+		list.head->_lruPrev = res;
+	else
+		list.tail = res;
+	list.head = res;
+	list.memory += res->size();
+}
+
+void ResourceManager::unlinkLRU(LRUListType type, Resource *res) {
+	LRUList &list = _LRU[type];
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		list.head = res->_lruNext;
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		list.tail = res->_lruPrev;
+	res->_lruPrev = res->_lruNext = nullptr;
+	list.memory -= res->size();
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+	unlinkLRU(res->_reused ? kLRUProtected : kLRUProbation, res);
 	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
@@ -1088,7 +1132,7 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
+	linkLRU(res->_reused ? kLRUProtected : kLRUProbation, res);
 	_memoryLRU += res->size();
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
@@ -1096,20 +1140,28 @@ void ResourceManager::addToLRU(Resource *res) {
 	      _memoryLRU);
 #endif
 	res->_status = kResStatusEnqueued;
+
+	// Demote the least recently used resources in the protected list, when
+	// it takes more than its share
+	LRUList &protectedList = _LRU[kLRUProtected];
+	while (protectedList.memory > PROTECTED_LRU_SHARE(_maxMemoryLRU) && protectedList.tail != res) {
+		Resource *demoted = protectedList.tail;
+		unlinkLRU(kLRUProtected, demoted);
+		demoted->_reused = false;
+		linkLRU(kLRUProbation, demoted);
+	}
 }
 
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
-
-	while (it != _LRU.end()) {
-		res = *it;
-		debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
-		mem += res->size();
-		++entries;
-		++it;
+
+	for (int i = 0; i < kLRUListCount; ++i) {
+		for (Resource *res = _LRU[i].head; res; res = res->_lruNext) {
+			debug("\t%s: %u bytes%s", res->_id.toString().c_str(), res->size(), i == kLRUProtected ? " (protected)" : "");
+			mem += res->size();
+			++entries;
+		}
 	}
 
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
@@ -1117,9 +1169,13 @@ void ResourceManager::printLRU() {
 
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+		Resource *goner = _LRU[kLRUProbation].tail;
+		if (!goner)
+			goner = _LRU[kLRUProtected].tail;
+		assert(goner);
 		removeFromLRU(goner);
+		_cacheStats.evictions++;
+		_cacheStats.evictedBytes += goner->size();
 		goner->unalloc();
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
@@ -1127,6 +1183,11 @@ void ResourceManager::freeOldResources() {
 	}
 }
 
+void ResourceManager::setMaxMemoryLRU(int maxMemory) {
+	_maxMemoryLRU = maxMemory;
+	freeOldResources();
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1152,15 +1213,20 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheStats.misses++;
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		// The resource is removed from its current position
-		// in the LRU list because it has been requested
-		// again. Below, it will either be locked, or it
-		// will be added back to the LRU list at the 'most
-		// recent' position.
-		removeFromLRU(retval);
+	} else {
+		_cacheStats.hits++;
+		if (retval->_status == kResStatusEnqueued)
+			// The resource is removed from its current position
+			// in the LRU list because it has been requested
+			// again. Below, it will either be locked, or it
+			// will be added back to the LRU list at the 'most
+			// recent' position.
+			removeFromLRU(retval);
+		retval->_reused = true;
+	}
 
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
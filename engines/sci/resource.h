@@ -299,6 +299,10 @@ protected:
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
+	Resource *_lruPrev; /**< Next more recently used resource in the same LRU list */
+	Resource *_lruNext; /**< Next less recently used resource in the same LRU list */
+	bool _reused; /**< Requested again since it has been loaded */
+
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
 	bool loadFromWaveFile(Common::SeekableReadStream *file);
@@ -310,6 +314,16 @@ protected:
 
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
+/** Statistics about the resource cache, for the debugger */
+struct ResourceCacheStats {
+	uint32 hits; /**< Requests for resources which were in memory */
+	uint32 misses; /**< Requests for resources which had to be loaded */
+	uint32 evictions; /**< Resources freed to stay within the memory budget */
+	uint32 evictedBytes; /**< Total size of these resources */
+
+	ResourceCacheStats() : hits(0), misses(0), evictions(0), evictedBytes(0) {}
+};
+
 class IntMapResourceSource;
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
@@ -366,6 +380,23 @@ public:
 	 */
 	void unlockResource(Resource *res);
 
+	const ResourceCacheStats &getCacheStats() const { return _cacheStats; }
+	void resetCacheStats() { _cacheStats = ResourceCacheStats(); }
+
+	/**
+	 * Returns the number of bytes currently used by resources under LRU
+	 * control, and the number of bytes used by locked resources.
+	 */
+	void getCacheMemory(int &lru, int &locked) const { lru = _memoryLRU; locked = _memoryLocked; }
+
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+
+	/**
+	 * Sets the amount of memory resources which are not locked may use, and
+	 * frees resources as necessary to stay within this budget.
+	 */
+	void setMaxMemoryLRU(int maxMemory);
+
 	/**
 	 * Tests whether a resource exists.
 	 *
@@ -479,7 +510,30 @@ protected:
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+
+	enum LRUListType {
+		kLRUProbation = 0, ///< Resources used only once so far
+		kLRUProtected = 1, ///< Resources used repeatedly
+		kLRUListCount
+	};
+
+	/** Intrusive list of resources, most recently used first */
+	struct LRUList {
+		Resource *head;
+		Resource *tail;
+		int memory; ///< Amount of resource bytes in this list
+	};
+
+	/**
+	 * Last Resource Used lists. Resources which have been requested again
+	 * after they were loaded are moved to the protected list, which may take
+	 * up to PROTECTED_LRU_SHARE of the memory budget, and are only freed after
+	 * all other ones. This keeps views and pics which are used all the time
+	 * from being pushed out by resources which are needed only once, e.g.
+	 * when changing rooms.
+	 */
+	LRUList _LRU[kLRUListCount];
+	ResourceCacheStats _cacheStats;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -614,6 +668,8 @@ protected:
 	void printLRU();
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
+	void linkLRU(LRUListType type, Resource *res);
+	void unlinkLRU(LRUListType type, Resource *res);
 
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
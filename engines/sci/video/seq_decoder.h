@@ -61,6 +61,7 @@ private:
 		const Graphics::Surface *decodeNextFrame();
 		const byte *getPalette() const;
 		bool hasDirtyPalette() const { return _dirtyPalette; }
+		bool canDecodeAhead() const { return true; }
 
 	protected:
 		Common::Rational getFrameRate() const { return Common::Rational(60, _frameDelay); }
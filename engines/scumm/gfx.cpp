@@ -214,6 +214,7 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_vertStripNextInc = 0;
 	_zbufferDisabled = false;
 	_objectMode = false;
+	_roomColor16bit = false;
 	_distaff = false;
 }
 
@@ -254,6 +255,7 @@ GdiV2::~GdiV2() {
 
 #ifdef USE_RGB_COLOR
 GdiHE16bit::GdiHE16bit(ScummEngine *vm) : GdiHE(vm) {
+	_roomColor16bit = true;
 }
 #endif
 
@@ -3326,6 +3328,22 @@ void Gdi::drawStripEGA(byte *dst, int dstPitch, const byte *src, int height) con
 	}
 }
 
+// Called for every pixel by the strip decoders, so this is a plain inline
+// function checking a flag rather than a virtual method.
+inline void Gdi::writeRoomColor(byte *dst, byte color) const {
+#ifdef USE_RGB_COLOR
+	if (_roomColor16bit) {
+		WRITE_UINT16(dst, READ_LE_UINT16(_vm->_hePalettes + 2048 + color * 2));
+		return;
+	}
+#endif
+	// As described in bug #1294513 "FOA/Amiga: Palette problem (Regression)"
+	// the original AMIGA version of Indy4: The Fate of Atlantis allowed
+	// overflowing of the palette index. To have the same result in our code,
+	// we need to do an logical AND 0xFF here to keep the result in [0, 255].
+	*dst = _roomPalette[(color + _paletteMod) & 0xFF];
+}
+
 #define READ_BIT (shift--, dataBit = data & 1, data >>= 1, dataBit)
 #define FILL_BITS(n) do {            \
 		if (shift < n) {             \
@@ -3337,6 +3355,7 @@ void Gdi::drawStripEGA(byte *dst, int dstPitch, const byte *src, int height) con
 // NOTE: drawStripHE is actually very similar to drawStripComplex
 void Gdi::drawStripHE(byte *dst, int dstPitch, const byte *src, int width, int height, const bool transpCheck) const {
 	static const int delta_color[] = { -4, -3, -2, -1, 1, 2, 3, 4 };
+	const int bytesPerPixel = _vm->_bytesPerPixel;
 	uint32 dataBit, data;
 	byte color;
 	int shift;
@@ -3350,11 +3369,11 @@ void Gdi::drawStripHE(byte *dst, int dstPitch, const byte *src, int width, int h
 	while (1) {
 		if (!transpCheck || color != _transparentColor)
 			writeRoomColor(dst, color);
-		dst += _vm->_bytesPerPixel;
+		dst += bytesPerPixel;
 		--x;
 		if (x == 0) {
 			x = width;
-			dst += dstPitch - width * _vm->_bytesPerPixel;
+			dst += dstPitch - width * bytesPerPixel;
 			--height;
 			if (height == 0)
 				return;
@@ -3427,6 +3446,7 @@ void Gdi::drawStrip3DO(byte *dst, int dstPitch, const byte *src, int height, con
 	} while (0)
 
 void Gdi::drawStripComplex(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const {
+	const int bytesPerPixel = _vm->_bytesPerPixel;
 	byte color = *src++;
 	uint bits = *src++;
 	byte cl = 8;
@@ -3439,7 +3459,7 @@ void Gdi::drawStripComplex(byte *dst, int dstPitch, const byte *src, int height,
 			FILL_BITS;
 			if (!transpCheck || color != _transparentColor)
 				writeRoomColor(dst, color);
-			dst += _vm->_bytesPerPixel;
+			dst += bytesPerPixel;
 
 		againPos:
 			if (!READ_BIT) {
@@ -3460,13 +3480,13 @@ void Gdi::drawStripComplex(byte *dst, int dstPitch, const byte *src, int height,
 					do {
 						if (!--x) {
 							x = 8;
-							dst += dstPitch - 8 * _vm->_bytesPerPixel;
+							dst += dstPitch - 8 * bytesPerPixel;
 							if (!--height)
 								return;
 						}
 						if (!transpCheck || color != _transparentColor)
 							writeRoomColor(dst, color);
-						dst += _vm->_bytesPerPixel;
+						dst += bytesPerPixel;
 					} while (--reps);
 					bits >>= 8;
 					bits |= (*src++) << (cl - 8);
@@ -3474,11 +3494,12 @@ void Gdi::drawStripComplex(byte *dst, int dstPitch, const byte *src, int height,
 				}
 			}
 		} while (--x);
-		dst += dstPitch - 8 * _vm->_bytesPerPixel;
+		dst += dstPitch - 8 * bytesPerPixel;
 	} while (--height);
 }
 
 void Gdi::drawStripBasicH(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const {
+	const int bytesPerPixel = _vm->_bytesPerPixel;
 	byte color = *src++;
 	uint bits = *src++;
 	byte cl = 8;
@@ -3491,7 +3512,7 @@ void Gdi::drawStripBasicH(byte *dst, int dstPitch, const byte *src, int height,
 			FILL_BITS;
 			if (!transpCheck || color != _transparentColor)
 				writeRoomColor(dst, color);
-			dst += _vm->_bytesPerPixel;
+			dst += bytesPerPixel;
 			if (!READ_BIT) {
 			} else if (!READ_BIT) {
 				FILL_BITS;
@@ -3506,7 +3527,7 @@ void Gdi::drawStripBasicH(byte *dst, int dstPitch, const byte *src, int height,
 				color += inc;
 			}
 		} while (--x);
-		dst += dstPitch - 8 * _vm->_bytesPerPixel;
+		dst += dstPitch - 8 * bytesPerPixel;
 	} while (--height);
 }
 
@@ -3576,6 +3597,31 @@ void Gdi::drawStripBasicV(byte *dst, int dstPitch, const byte *src, int height,
 			}                              \
 		} while (0)
 
+/**
+ * Return a mask with all bits set in every byte of the row which is equal
+ * to the given color, and all bits clear in all other bytes.
+ */
+static inline uint64 matchRowColor(uint64 row, byte color) {
+	const uint64 low7 = 0x7F7F7F7F7F7F7F7FULL;
+	// A byte of x is zero exactly where the row matches. Adding 0x7F to the
+	// low seven bits of a byte cannot carry into the next byte, and sets
+	// the top bit unless the byte is zero.
+	const uint64 x = row ^ (0x0101010101010101ULL * color);
+	const uint64 nonZero = ((x & low7) + low7) | x;
+	return ((~nonZero >> 7) & 0x0101010101010101ULL) * 0xFF;
+}
+
+bool Gdi::hasIdentityRoomPalette() const {
+	if (_paletteMod)
+		return false;
+
+	for (int i = 0; i < 256; i++) {
+		if (_roomPalette[i] != i)
+			return false;
+	}
+	return true;
+}
+
 void Gdi::drawStripRaw(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const {
 	int x;
 
@@ -3586,12 +3632,38 @@ void Gdi::drawStripRaw(byte *dst, int dstPitch, const byte *src, int height, con
 			*dst = _roomPalette[*src++];
 			NEXT_ROW;
 		}
+	} else if (_vm->_bytesPerPixel == 1 && !_roomColor16bit && hasIdentityRoomPalette()) {
+		// The colors are written as they are, so a whole row of eight
+		// pixels can be merged with the transparent ones in one go.
+		do {
+			const uint64 row = READ_UINT64(src);
+			if (transpCheck) {
+				const uint64 transparent = matchRowColor(row, _transparentColor);
+				if (transparent)
+					WRITE_UINT64(dst, (row & ~transparent) | (READ_UINT64(dst) & transparent));
+				else
+					WRITE_UINT64(dst, row);
+			} else {
+				WRITE_UINT64(dst, row);
+			}
+			src += 8;
+			dst += dstPitch;
+		} while (--height);
 	} else {
+		const int bytesPerPixel = _vm->_bytesPerPixel;
 		do {
+			if (transpCheck) {
+				const uint64 transparent = matchRowColor(READ_UINT64(src), _transparentColor);
+				if (transparent == 0xFFFFFFFFFFFFFFFFULL) {
+					src += 8;
+					dst += dstPitch;
+					continue;
+				}
+			}
 			for (x = 0; x < 8; x ++) {
 				byte color = *src++;
 				if (!transpCheck || color != _transparentColor)
-					writeRoomColor(dst + x * _vm->_bytesPerPixel, color);
+					writeRoomColor(dst + x * bytesPerPixel, color);
 			}
 			dst += dstPitch;
 		} while (--height);
@@ -3714,20 +3786,6 @@ void Gdi::unkDecode11(byte *dst, int dstPitch, const byte *src, int height) cons
 #undef NEXT_ROW
 #undef READ_BIT_256
 
-#ifdef USE_RGB_COLOR
-void GdiHE16bit::writeRoomColor(byte *dst, byte color) const {
-	WRITE_UINT16(dst, READ_LE_UINT16(_vm->_hePalettes + 2048 + color * 2));
-}
-#endif
-
-void Gdi::writeRoomColor(byte *dst, byte color) const {
-	// As described in bug #1294513 "FOA/Amiga: Palette problem (Regression)"
-	// the original AMIGA version of Indy4: The Fate of Atlantis allowed
-	// overflowing of the palette index. To have the same result in our code,
-	// we need to do an logical AND 0xFF here to keep the result in [0, 255].
-	*dst = _roomPalette[(color + _paletteMod) & 0xFF];
-}
-
 
 #pragma mark -
 #pragma mark --- Transition effects ---
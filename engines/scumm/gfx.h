@@ -209,6 +209,9 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/** Flag which is true when room colors are written as 16-bit HE palette entries. */
+	bool _roomColor16bit;
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -235,7 +238,10 @@ protected:
 	void drawStrip3DO(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const;
 
 	void drawStripHE(byte *dst, int dstPitch, const byte *src, int width, int height, const bool transpCheck) const;
-	virtual void writeRoomColor(byte *dst, byte color) const;
+	inline void writeRoomColor(byte *dst, byte color) const;
+
+	/** Whether writeRoomColor() would write every 8-bit color unchanged. */
+	bool hasIdentityRoomPalette() const;
 
 	/* Mask decompressors */
 	void decompressMaskImgOr(byte *dst, const byte *src, int height) const;
@@ -448,8 +454,6 @@ public:
 
 #ifdef USE_RGB_COLOR
 class GdiHE16bit : public GdiHE {
-protected:
-	virtual void writeRoomColor(byte *dst, byte color) const;
 public:
 	GdiHE16bit(ScummEngine *vm);
 };
@@ -48,6 +48,7 @@ enum {
 	RF_USAGE_MAX = RF_USAGE,
 
 	RS_MODIFIED = 0x10,
+	RS_EXPIRED = 0x20,
 	RF_OFFHEAP = 0x40
 };
 
@@ -831,6 +832,11 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 	memset(ptr, 0, size + SAFETY_AREA);
 	_allocatedSize += size;
 
+	if (_types[type][idx].isExpired()) {
+		_types[type][idx].setExpired(false);
+		_reloadedNum++;
+	}
+
 	_types[type][idx]._address = ptr;
 	_types[type][idx]._size = size;
 	setResourceCounter(type, idx, 1);
@@ -872,6 +878,9 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_expiredNum = 0;
+	_expiredSize = 0;
+	_reloadedNum = 0;
 }
 
 ResourceManager::~ResourceManager() {
@@ -1032,10 +1041,18 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
+void ResourceManager::Resource::setExpired(bool expired) {
+	if (expired)
+		_status |= RS_EXPIRED;
+	else
+		_status &= ~RS_EXPIRED;
+}
+
+bool ResourceManager::Resource::isExpired() const {
+	return (_status & RS_EXPIRED) != 0;
+}
+
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -1048,31 +1065,52 @@ void ResourceManager::expireResources(uint32 size) {
 
 	oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
+	// Expiring a resource doesn't affect whether any other resource may be
+	// expired, so instead of searching for the oldest resource again after
+	// every expiry, collect all candidates once and expire them oldest first.
+	// Candidates are gathered from the last type and first index on, so that
+	// among resources of equal age the same one is picked as by a full search.
+	Common::Array<ExpireCandidate> candidates;
+	uint counterNum[RF_USAGE_MAX + 1];
+	memset(counterNum, 0, sizeof(counterNum));
+
+	for (ResType type = rtLast; type >= rtFirst; type = ResType(type - 1)) {
+		if (_types[type]._mode != kDynamicResTypeMode) {
+			// Resources of this type can be reloaded from the data files,
+			// so we can potentially unload them to free memory.
+			for (ResId idx = 0; idx < _types[type].size(); idx++) {
+				Resource &tmp = _types[type][idx];
+				byte counter = tmp.getResourceCounter();
+				if (!tmp.isLocked() && counter >= 2 && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
+					ExpireCandidate candidate = { type, idx, counter };
+					candidates.push_back(candidate);
+					counterNum[counter]++;
 				}
 			}
 		}
+	}
+
+	// Counting sort by descending age, keeping the gathering order for ties
+	uint counterPos[RF_USAGE_MAX + 1];
+	uint pos = 0;
+	for (int counter = RF_USAGE_MAX; counter >= 0; counter--) {
+		counterPos[counter] = pos;
+		pos += counterNum[counter];
+	}
 
-		if (!best_type)
+	Common::Array<ExpireCandidate> sorted(candidates.size());
+	for (uint i = 0; i < candidates.size(); i++)
+		sorted[counterPos[candidates[i].counter]++] = candidates[i];
+
+	for (uint i = 0; i < sorted.size(); i++) {
+		_expiredNum++;
+		_expiredSize += _types[sorted[i].type][sorted[i].idx]._size;
+		nukeResource(sorted[i].type, sorted[i].idx);
+		_types[sorted[i].type][sorted[i].idx].setExpired(true);
+
+		if (size + _allocatedSize <= _minHeapThreshold)
 			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+	}
 
 	increaseResourceCounters();
 
@@ -1134,6 +1172,7 @@ void ResourceManager::resourceStats() {
 	}
 
 	debug(1, "Total allocated size=%d, locked=%d(%d)", _allocatedSize, lockedSize, lockedNum);
+	debug(1, "Expired %d resources (%d bytes), reloaded %d", _expiredNum, _expiredSize, _reloadedNum);
 }
 
 void ScummEngine_v5::readMAXS(int blockSize) {
@@ -105,8 +105,9 @@ public:
 		byte _flags;
 
 		/**
-		 * The status of the resource. Currently only one bit is used, which
-		 * indicates whether the resource is modified.
+		 * The status of the resource. The bits indicate whether the resource
+		 * is modified, kept off the heap, or was last unloaded by
+		 * expireResources().
 		 */
 		byte _status;
 
@@ -145,6 +146,9 @@ public:
 		void setOffHeap();
 		void setOnHeap();
 		bool isOffHeap() const;
+
+		void setExpired(bool expired);
+		bool isExpired() const;
 	};
 
 	/**
@@ -172,10 +176,26 @@ public:
 	ResTypeData _types[rtLast + 1];
 
 protected:
+	/**
+	 * A resource which expireResources() may unload to free memory.
+	 */
+	struct ExpireCandidate {
+		ResType type;
+		ResId idx;
+		byte counter;
+	};
+
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	/**
+	 * Statistics about resources that were unloaded to free memory,
+	 * and then had to be loaded again.
+	 */
+	uint32 _expiredNum, _expiredSize;
+	uint32 _reloadedNum;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
@@ -61,6 +61,50 @@ void TTparser::clear() {
 	_currentWordP = nullptr;
 }
 
+void ReplacementArray::buildIndex() {
+	_index.clear();
+
+	for (uint idx = 0; idx < size(); idx += 2) {
+		const CString &origStr = (*this)[idx];
+		int wordLen = origStr.indexOf(' ');
+		if (wordLen < 0)
+			wordLen = origStr.size();
+
+		_index[Common::String(origStr.c_str(), wordLen)].push_back(idx);
+	}
+
+	// Search strings with an empty first word may match at any word, so
+	// merge them into the candidates of all the other words
+	if (_index.contains("")) {
+		const IndexArray &anyWord = _index[""];
+		for (Common::HashMap<Common::String, IndexArray>::iterator i = _index.begin(); i != _index.end(); ++i) {
+			if (i->_key.empty())
+				continue;
+
+			IndexArray merged;
+			uint wordIdx = 0, anyIdx = 0;
+			while (wordIdx < i->_value.size() || anyIdx < anyWord.size()) {
+				if (anyIdx == anyWord.size() || (wordIdx < i->_value.size() && i->_value[wordIdx] < anyWord[anyIdx]))
+					merged.push_back(i->_value[wordIdx++]);
+				else
+					merged.push_back(anyWord[anyIdx++]);
+			}
+
+			i->_value = merged;
+		}
+	}
+}
+
+const ReplacementArray::IndexArray &ReplacementArray::findCandidates(const Common::String &word) const {
+	static const IndexArray EMPTY;
+
+	Common::HashMap<Common::String, IndexArray>::const_iterator i = _index.find(word);
+	if (i == _index.end())
+		i = _index.find("");
+
+	return (i == _index.end()) ? EMPTY : i->_value;
+}
+
 void TTparser::loadArray(StringArray &arr, const CString &name) {
 	Common::SeekableReadStream *r = g_vm->_filesManager->getResource(name);
 	while (r->pos() < r->size())
@@ -72,6 +116,9 @@ void TTparser::loadArrays() {
 	loadArray(_replacements1, "TEXT/REPLACEMENTS1");
 	loadArray(_replacements2, "TEXT/REPLACEMENTS2");
 	loadArray(_replacements3, "TEXT/REPLACEMENTS3");
+	_replacements1.buildIndex();
+	_replacements2.buildIndex();
+	_replacements3.buildIndex();
 	if (g_language == Common::DE_DEU)
 		loadArray(_replacements4, "TEXT/REPLACEMENTS4");
 	loadArray(_phrases, "TEXT/PHRASES");
@@ -363,18 +410,25 @@ bool TTparser::normalizeContraction(const TTstring &srcLine, int &srcIndex, TTst
 	return false;
 }
 
-void TTparser::searchAndReplace(TTstring &line, const StringArray &strings) {
+void TTparser::searchAndReplace(TTstring &line, const ReplacementArray &strings) {
 	int charIndex = 0;
 	while (charIndex >= 0)
 		charIndex = searchAndReplace(line, charIndex, strings);
 }
 
-int TTparser::searchAndReplace(TTstring &line, int startIndex, const StringArray &strings) {
+int TTparser::searchAndReplace(TTstring &line, int startIndex, const ReplacementArray &strings) {
 	int lineSize = line.size();
 	if (startIndex >= lineSize)
 		return -1;
 
-	for (uint idx = 0; idx < strings.size(); idx += 2) {
+	// Only check the pairs whose search string starts with the current word
+	const char *wordP = line.c_str() + startIndex;
+	const char *wordEndP = strchr(wordP, ' ');
+	Common::String word = wordEndP ? Common::String(wordP, wordEndP) : Common::String(wordP);
+	const ReplacementArray::IndexArray &candidates = strings.findCandidates(word);
+
+	for (uint candidateIdx = 0; candidateIdx < candidates.size(); ++candidateIdx) {
+		uint idx = candidates[candidateIdx];
 		const CString &origStr = strings[idx];
 		const CString &replacementStr = strings[idx + 1];
 
@@ -23,6 +23,8 @@
 #ifndef TITANIC_TT_PARSER_H
 #define TITANIC_TT_PARSER_H
 
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "titanic/true_talk/tt_node.h"
 #include "titanic/true_talk/tt_pronoun.h"
 #include "titanic/true_talk/tt_sentence.h"
@@ -56,6 +58,30 @@ struct NumberEntry {
 };
 typedef Common::Array<NumberEntry> NumberArray;
 
+/**
+ * A list of string pairs, with the first being a string to search for and
+ * the second its replacement. The pairs are indexed on the first word of
+ * the search string, since a search string can only match at the start of
+ * a word that's equal to its own first word.
+ */
+class ReplacementArray : public StringArray {
+public:
+	typedef Common::Array<uint> IndexArray;
+private:
+	Common::HashMap<Common::String, IndexArray> _index;
+public:
+	/**
+	 * Builds the index, once all the string pairs have been added
+	 */
+	void buildIndex();
+
+	/**
+	 * Returns the indexes of the pairs, in ascending order, that may match
+	 * at the start of a given word
+	 */
+	const IndexArray &findCandidates(const Common::String &word) const;
+};
+
 class TTparserNode : public TTnode {
 public:
 	uint _tag;
@@ -66,9 +92,9 @@ public:
 
 class TTparser {
 private:
-	StringArray _replacements1;
-	StringArray _replacements2;
-	StringArray _replacements3;
+	ReplacementArray _replacements1;
+	ReplacementArray _replacements2;
+	ReplacementArray _replacements3;
 	StringArray _replacements4;
 	StringArray _phrases;
 	NumberArray _numbers;
@@ -115,7 +141,7 @@ private:
 	 * @param strings		List of strings to check for. Strings come in pairs, with the
 	 * first being the string to match, and the second the replacement
 	 */
-	static void searchAndReplace(TTstring &line, const StringArray &strings);
+	static void searchAndReplace(TTstring &line, const ReplacementArray &strings);
 
 	/**
 	 * Checks the string starting at a given index for any word in the passed string array,
@@ -126,7 +152,7 @@ private:
 	 * first being the string to match, and the second the replacement
 	 * @returns				Index of the start of the following word
 	 */
-	static int searchAndReplace(TTstring &line, int startIndex, const StringArray &strings);
+	static int searchAndReplace(TTstring &line, int startIndex, const ReplacementArray &strings);
 
 	/**
 	* Checks the string starting at a given index for a number representation
@@ -36,6 +36,7 @@ namespace Titanic {
 TTvocab::TTvocab(VocabMode vocabMode): _headP(nullptr), _tailP(nullptr),
 		_word(nullptr), _vocabMode(vocabMode) {
 	load("STVOCAB");
+	buildIndex();
 }
 
 TTvocab::~TTvocab() {
@@ -156,6 +157,27 @@ void TTvocab::addWord(TTword *word) {
 	}
 }
 
+void TTvocab::buildIndex() {
+	_index.clear();
+
+	// Words are added in list order, so that a lookup gives the same word
+	// as a scan of the list would
+	for (TTword *word = _headP; word; word = word->_nextP) {
+		if (_vocabMode == VOCAB_MODE_EN)
+			addIndexName(word->_text, word);
+
+		for (TTstringNode *nodeP = word->_synP; nodeP; nodeP = dynamic_cast<TTstringNode *>(nodeP->_nextP)) {
+			if (nodeP->_mode == _vocabMode || (_vocabMode == VOCAB_MODE_EN && nodeP->_mode < 3))
+				addIndexName(nodeP->_string, word);
+		}
+	}
+}
+
+void TTvocab::addIndexName(const TTstring &name, TTword *word) {
+	if (name.isValid() && !_index.contains(name.c_str()))
+		_index[name.c_str()] = word;
+}
+
 TTword *TTvocab::findWord(const TTstring &str) {
 	TTsynonym *tempNode = new TTsynonym();
 	bool flag = false;
@@ -203,22 +225,22 @@ TTword *TTvocab::getPrimeWord(TTstring &str, TTword **srcWord) const {
 		vocabP = _headP;
 		newWord = new TTword(str, WC_ABSTRACT, 300);
 	} else {
-		// Standard word
-		for (vocabP = _headP; vocabP; vocabP = vocabP->_nextP) {
-			if (_vocabMode == VOCAB_MODE_EN && !strcmp(str.c_str(), vocabP->c_str())) {
-				newWord = vocabP->copy();
-				newWord->_nextP = nullptr;
-				newWord->setSyn(nullptr);
-				break;
-			} else if (vocabP->findSynByName(str, &tempSyn, _vocabMode)) {
-				// Create a copy of the word and the found synonym
-				TTsynonym *newSyn = new TTsynonym(tempSyn);
-				newSyn->_nextP = newSyn->_priorP = nullptr;
-				newWord = vocabP->copy();
-				newWord->_nextP = nullptr;
-				newWord->setSyn(newSyn);
-				break;
-			}
+		// Standard word. The index gives the first word in the vocab list
+		// whose text or one of its synonyms matches
+		Common::HashMap<Common::String, TTword *>::const_iterator i = _index.find(str.c_str());
+		vocabP = (i != _index.end()) ? i->_value : nullptr;
+
+		if (vocabP && _vocabMode == VOCAB_MODE_EN && !strcmp(str.c_str(), vocabP->c_str())) {
+			newWord = vocabP->copy();
+			newWord->_nextP = nullptr;
+			newWord->setSyn(nullptr);
+		} else if (vocabP && vocabP->findSynByName(str, &tempSyn, _vocabMode)) {
+			// Create a copy of the word and the found synonym
+			TTsynonym *newSyn = new TTsynonym(tempSyn);
+			newSyn->_nextP = newSyn->_priorP = nullptr;
+			newWord = vocabP->copy();
+			newWord->_nextP = nullptr;
+			newWord->setSyn(newSyn);
 		}
 	}
 
@@ -23,6 +23,8 @@
 #ifndef TITANIC_ST_VOCAB_H
 #define TITANIC_ST_VOCAB_H
 
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "titanic/support/exe_resources.h"
 #include "titanic/support/string.h"
 #include "titanic/true_talk/tt_string.h"
@@ -36,12 +38,28 @@ private:
 	TTword *_tailP;
 	TTword *_word;
 	VocabMode _vocabMode;
+
+	/**
+	 * Maps each word text and synonym to the first word in the vocab
+	 * list that it matches
+	 */
+	Common::HashMap<Common::String, TTword *> _index;
 private:
 	/**
 	 * Load the vocab data
 	 */
 	int load(const CString &name);
 
+	/**
+	 * Builds the index of word texts and synonyms once the vocab is loaded
+	 */
+	void buildIndex();
+
+	/**
+	 * Adds a name to the index, unless an earlier word already has it
+	 */
+	void addIndexName(const TTstring &name, TTword *word);
+
 	/**
 	 * Adds a specified word to the vocab list
 	 */
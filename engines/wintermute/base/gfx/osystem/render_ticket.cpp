@@ -29,6 +29,7 @@
 
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/gfx/osystem/render_ticket.h"
+#include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
 #include "engines/wintermute/base/gfx/osystem/base_surface_osystem.h"
 #include "graphics/transform_tools.h"
 #include "common/textconsole.h"
@@ -43,14 +44,7 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	_wantsDraw(true),
 	_transform(transform) {
 	if (surf) {
-		_surface = new Graphics::Surface();
-		_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
-		assert(_surface->format.bytesPerPixel == 4);
-		// Get a clipped copy of the surface
-		for (int i = 0; i < _surface->h; i++) {
-			memcpy(_surface->getBasePtr(0, i), surf->getBasePtr(srcRect->left, srcRect->top + i), srcRect->width() * _surface->format.bytesPerPixel);
-		}
-		// Then scale it if necessary
+		// Scale/rotate the surface if necessary
 		//
 		// NB: The numTimesX/numTimesY properties don't yet mix well with
 		// scaling and rotation, but there is no need for that functionality at
@@ -58,30 +52,51 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 		// NB: Mirroring and rotation are probably done in the wrong order.
 		// (Mirroring should most likely be done before rotation. See also
 		// TransformTools.)
-		if (_transform._angle != Graphics::kDefaultAngle) {
-			Graphics::TransparentSurface src(*_surface, false);
-			Graphics::Surface *temp;
-			if (owner->_gameRef->getBilinearFiltering()) {
-				temp = src.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
+		bool rotate = _transform._angle != Graphics::kDefaultAngle;
+		bool scale = !rotate &&
+					 (dstRect->width() != srcRect->width() ||
+					  dstRect->height() != srcRect->height()) &&
+					 _transform._numTimesX * _transform._numTimesY == 1;
+
+		if (rotate || scale) {
+			// The same sprite is often drawn with the same transform at
+			// another position, so reuse earlier results where possible
+			Graphics::TransformCache &cache = static_cast<BaseRenderOSystem *>(owner->_gameRef->_renderer)->getTransformCache();
+			bool bilinear = owner->_gameRef->getBilinearFiltering();
+			Graphics::TransformCache::Key key(owner, *srcRect, transform, (uint16)dstRect->width(), (uint16)dstRect->height(),
+			                                  bilinear ? Graphics::FILTER_BILINEAR : Graphics::FILTER_NEAREST);
+
+			const Graphics::Surface *cached = cache.find(key);
+			if (cached) {
+				_surface = new Graphics::Surface();
+				_surface->copyFrom(*cached);
 			} else {
-				temp = src.rotoscaleT<Graphics::FILTER_NEAREST>(transform);
+				// Resample straight from the clipped area of the surface
+				Graphics::TransparentSurface src(surf->getSubArea(*srcRect), false);
+				assert(src.format.bytesPerPixel == 4);
+				if (rotate) {
+					if (bilinear) {
+						_surface = src.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
+					} else {
+						_surface = src.rotoscaleT<Graphics::FILTER_NEAREST>(transform);
+					}
+				} else {
+					if (bilinear) {
+						_surface = src.scaleT<Graphics::FILTER_BILINEAR>(dstRect->width(), dstRect->height());
+					} else {
+						_surface = src.scaleT<Graphics::FILTER_NEAREST>(dstRect->width(), dstRect->height());
+					}
+				}
+				cache.insert(key, *_surface);
 			}
-			_surface->free();
-			delete _surface;
-			_surface = temp;
-		} else if ((dstRect->width() != srcRect->width() ||
-					dstRect->height() != srcRect->height()) &&
-					_transform._numTimesX * _transform._numTimesY == 1) {
-			Graphics::TransparentSurface src(*_surface, false);
-			Graphics::Surface *temp;
-			if (owner->_gameRef->getBilinearFiltering()) {
-				temp = src.scaleT<Graphics::FILTER_BILINEAR>(dstRect->width(), dstRect->height());
-			} else {
-				temp = src.scaleT<Graphics::FILTER_NEAREST>(dstRect->width(), dstRect->height());
+		} else {
+			_surface = new Graphics::Surface();
+			_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
+			assert(_surface->format.bytesPerPixel == 4);
+			// Get a clipped copy of the surface
+			for (int i = 0; i < _surface->h; i++) {
+				memcpy(_surface->getBasePtr(0, i), surf->getBasePtr(srcRect->left, srcRect->top + i), srcRect->width() * _surface->format.bytesPerPixel);
 			}
-			_surface->free();
-			delete _surface;
-			_surface = temp;
 		}
 	} else {
 		_surface = nullptr;
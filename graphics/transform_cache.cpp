@@ -0,0 +1,132 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transform_cache.h"
+
+namespace Graphics {
+
+TransformCache::Key::Key(const void *owner, const Common::Rect &srcRect, const TransformStruct &transform, uint16 width, uint16 height, TFilteringMode filteringMode) :
+	_owner(owner),
+	_srcRect(srcRect),
+	_zoom(transform._zoom),
+	_hotspot(transform._hotspot),
+	_angle(transform._angle),
+	_width(width),
+	_height(height),
+	_filteringMode(filteringMode) {
+}
+
+bool TransformCache::Key::operator==(const Key &key) const {
+	return _owner == key._owner &&
+		   _srcRect == key._srcRect &&
+		   _zoom == key._zoom &&
+		   _hotspot == key._hotspot &&
+		   _angle == key._angle &&
+		   _width == key._width &&
+		   _height == key._height &&
+		   _filteringMode == key._filteringMode;
+}
+
+uint TransformCache::KeyHash::operator()(const Key &key) const {
+	uint hash = (uint)(size_t)key._owner;
+	const int32 values[] = {
+		key._srcRect.left, key._srcRect.top, key._srcRect.right, key._srcRect.bottom,
+		key._zoom.x, key._zoom.y, key._hotspot.x, key._hotspot.y,
+		key._angle, key._width, key._height, key._filteringMode
+	};
+	for (int i = 0; i < ARRAYSIZE(values); i++) {
+		hash = hash * 31 + (uint)values[i];
+	}
+	return hash;
+}
+
+TransformCache::TransformCache(uint32 maxSize) : _size(0), _maxSize(maxSize) {
+}
+
+TransformCache::~TransformCache() {
+	clear();
+}
+
+const Surface *TransformCache::find(const Key &key) {
+	EntryMap::iterator it = _lookup.find(key);
+	if (it == _lookup.end()) {
+		return nullptr;
+	}
+
+	// Move the entry to the front of the list
+	if (it->_value != _entries.begin()) {
+		Entry entry = *it->_value;
+		_entries.erase(it->_value);
+		_entries.push_front(entry);
+		it->_value = _entries.begin();
+	}
+	return it->_value->_surface;
+}
+
+void TransformCache::insert(const Key &key, const Surface &surface) {
+	const uint32 size = surface.w * surface.h * surface.format.bytesPerPixel;
+	if (size > _maxSize) {
+		return;
+	}
+
+	EntryMap::iterator it = _lookup.find(key);
+	if (it != _lookup.end()) {
+		remove(it->_value);
+	}
+	while (_size + size > _maxSize) {
+		remove(--_entries.end());
+	}
+
+	Surface *copy = new Surface();
+	copy->copyFrom(surface);
+	_entries.push_front(Entry(key, copy, size));
+	_lookup[key] = _entries.begin();
+	_size += size;
+}
+
+void TransformCache::invalidate(const void *owner) {
+	EntryList::iterator it = _entries.begin();
+	while (it != _entries.end()) {
+		EntryList::iterator next = it;
+		++next;
+		if (it->_key._owner == owner) {
+			remove(it);
+		}
+		it = next;
+	}
+}
+
+void TransformCache::clear() {
+	while (!_entries.empty()) {
+		remove(_entries.begin());
+	}
+}
+
+void TransformCache::remove(EntryList::iterator entry) {
+	_lookup.erase(entry->_key);
+	_size -= entry->_size;
+	entry->_surface->free();
+	delete entry->_surface;
+	_entries.erase(entry);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TRANSFORM_CACHE_H
+#define GRAPHICS_TRANSFORM_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/noncopyable.h"
+#include "common/rect.h"
+#include "graphics/transform_struct.h"
+#include "graphics/transparent_surface.h"
+
+namespace Graphics {
+
+/**
+ * A size bounded cache of scaled and rotated sprites.
+ *
+ * Resampling a sprite is far more expensive than copying the result, and a
+ * zoomed sprite is usually drawn with the same frame and zoom many times, at
+ * different positions. The cache keeps the most recently used results until
+ * their total size exceeds the budget given on construction.
+ *
+ * Entries are keyed on an owner, which stands for the source pixels, and the
+ * transform applied to them. The owner must call invalidate() whenever those
+ * pixels change or go away.
+ */
+class TransformCache : Common::NonCopyable {
+public:
+	/**
+	 * Identifies one transformed sprite. The blend mode, color modulation,
+	 * mirroring and position of the transform are applied when blitting and
+	 * are not part of the key.
+	 */
+	struct Key {
+		Key(const void *owner, const Common::Rect &srcRect, const TransformStruct &transform, uint16 width, uint16 height, TFilteringMode filteringMode);
+
+		const void *_owner;
+		Common::Rect _srcRect;
+		Common::Point _zoom;
+		Common::Point _hotspot;
+		int32 _angle;
+		uint16 _width;
+		uint16 _height;
+		TFilteringMode _filteringMode;
+
+		bool operator==(const Key &key) const;
+	};
+
+	/**
+	 * @param maxSize the budget for the pixel data of all entries, in bytes
+	 */
+	explicit TransformCache(uint32 maxSize);
+	~TransformCache();
+
+	/**
+	 * Look up a transformed sprite and mark it as most recently used.
+	 * @return the cached surface, valid until the next call to insert(),
+	 * invalidate() or clear(), or 0 if there is none
+	 */
+	const Surface *find(const Key &key);
+
+	/**
+	 * Store a copy of a transformed sprite, evicting the least recently used
+	 * entries to stay within the budget. Sprites larger than the whole budget
+	 * are not stored.
+	 */
+	void insert(const Key &key, const Surface &surface);
+
+	/**
+	 * Drop every entry of the given owner.
+	 */
+	void invalidate(const void *owner);
+
+	void clear();
+
+	/**
+	 * @return the size of the pixel data of all entries, in bytes
+	 */
+	uint32 getSize() const { return _size; }
+
+private:
+	struct Entry {
+		Key _key;
+		Surface *_surface;
+		uint32 _size;
+
+		Entry(const Key &key, Surface *surface, uint32 size) : _key(key), _surface(surface), _size(size) {}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const;
+	};
+
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<Key, EntryList::iterator, KeyHash> EntryMap;
+
+	void remove(EntryList::iterator entry);
+
+	/** The entries, most recently used first */
+	EntryList _entries;
+	EntryMap _lookup;
+	uint32 _size;
+	uint32 _maxSize;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -37,6 +37,14 @@
 #include "graphics/transparent_surface.h"
 #include "graphics/transform_tools.h"
 
+#if defined(__SSE2__)
+#define USE_SSE2_BLIT
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define USE_NEON_BLIT
+#include <arm_neon.h>
+#endif
+
 namespace Graphics {
 
 static const int kBModShift = 0;//img->format.bShift;
@@ -129,6 +137,274 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	}
 }
 
+/*
+ * Vectorized row kernels for the blend loops below. Each one handles as many
+ * pixels of an unflipped row (inStep == 4) as fits its vector width and
+ * returns how many it did; the scalar loop finishes the rest of the row. The
+ * results are bit-exact with the scalar code: all intermediate values fit in
+ * 16 bits, and (x * y) >> 16 is computed with a widening multiply.
+ */
+#if defined(USE_SSE2_BLIT)
+
+static inline __m128i broadcastAlpha(__m128i x) {
+	x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+	return _mm_shufflehi_epi16(x, _MM_SHUFFLE(kAIndex, kAIndex, kAIndex, kAIndex));
+}
+
+// Per byte select: dst where keep is set, res otherwise
+static inline __m128i selectPixels(__m128i keep, __m128i dst, __m128i res) {
+	return _mm_or_si128(_mm_and_si128(keep, dst), _mm_andnot_si128(keep, res));
+}
+
+static uint32 blendAlphaRow(const byte *in, byte *out, uint32 width) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32(0xFF << (kAIndex * 8));
+	const __m128i max = _mm_set1_epi16(255);
+
+	uint32 j = 0;
+	for (; j + 4 <= width; j += 4, in += 16, out += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)in);
+		const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+		const __m128i src0 = _mm_unpacklo_epi8(src, zero), src1 = _mm_unpackhi_epi8(src, zero);
+		const __m128i dst0 = _mm_unpacklo_epi8(dst, zero), dst1 = _mm_unpackhi_epi8(dst, zero);
+		const __m128i a0 = broadcastAlpha(src0), a1 = broadcastAlpha(src1);
+
+		const __m128i res0 = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(src0, a0), _mm_mullo_epi16(dst0, _mm_sub_epi16(max, a0))), 8);
+		const __m128i res1 = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(src1, a1), _mm_mullo_epi16(dst1, _mm_sub_epi16(max, a1))), 8);
+		const __m128i res = _mm_or_si128(_mm_packus_epi16(res0, res1), alphaMask);
+
+		const __m128i skip = _mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), zero);
+		_mm_storeu_si128((__m128i *)out, selectPixels(skip, dst, res));
+	}
+	return j;
+}
+
+static uint32 blendAlphaColorRow(const byte *in, byte *out, uint32 width, byte ca, byte cr, byte cg, byte cb) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32(0xFF << (kAIndex * 8));
+	const __m128i max = _mm_set1_epi16(255);
+	const __m128i caVec = _mm_set1_epi16(ca);
+	uint16 mod[8];
+	mod[kAIndex] = mod[kAIndex + 4] = 0;
+	mod[kRIndex] = mod[kRIndex + 4] = cr;
+	mod[kGIndex] = mod[kGIndex + 4] = cg;
+	mod[kBIndex] = mod[kBIndex + 4] = cb;
+	const __m128i modVec = _mm_loadu_si128((const __m128i *)mod);
+
+	uint32 j = 0;
+	for (; j + 4 <= width; j += 4, in += 16, out += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)in);
+		const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+		const __m128i src0 = _mm_unpacklo_epi8(src, zero), src1 = _mm_unpackhi_epi8(src, zero);
+		const __m128i dst0 = _mm_unpacklo_epi8(dst, zero), dst1 = _mm_unpackhi_epi8(dst, zero);
+		const __m128i ina0 = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlpha(src0), caVec), 8);
+		const __m128i ina1 = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlpha(src1), caVec), 8);
+
+		const __m128i res0 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(dst0, _mm_sub_epi16(max, ina0)), 8),
+		                                   _mm_mulhi_epu16(_mm_mullo_epi16(src0, ina0), modVec));
+		const __m128i res1 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(dst1, _mm_sub_epi16(max, ina1)), 8),
+		                                   _mm_mulhi_epu16(_mm_mullo_epi16(src1, ina1), modVec));
+		const __m128i res = _mm_or_si128(_mm_packus_epi16(res0, res1), alphaMask);
+
+		const __m128i skip = _mm_packs_epi16(_mm_cmpeq_epi16(ina0, zero), _mm_cmpeq_epi16(ina1, zero));
+		_mm_storeu_si128((__m128i *)out, selectPixels(skip, dst, res));
+	}
+	return j;
+}
+
+static uint32 blendAdditiveRow(const byte *in, byte *out, uint32 width) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32(0xFF << (kAIndex * 8));
+
+	uint32 j = 0;
+	for (; j + 4 <= width; j += 4, in += 16, out += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)in);
+		const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+		const __m128i src0 = _mm_unpacklo_epi8(src, zero), src1 = _mm_unpackhi_epi8(src, zero);
+		const __m128i dst0 = _mm_unpacklo_epi8(dst, zero), dst1 = _mm_unpackhi_epi8(dst, zero);
+
+		// Saturating pack does the clamping to 255
+		const __m128i res0 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(src0, broadcastAlpha(src0)), 8), dst0);
+		const __m128i res1 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(src1, broadcastAlpha(src1)), 8), dst1);
+		const __m128i res = _mm_packus_epi16(res0, res1);
+
+		// The target alpha is left alone
+		const __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), zero), alphaMask);
+		_mm_storeu_si128((__m128i *)out, selectPixels(keep, dst, res));
+	}
+	return j;
+}
+
+static uint32 blendSubtractiveRow(const byte *in, byte *out, uint32 width) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32(0xFF << (kAIndex * 8));
+
+	uint32 j = 0;
+	for (; j + 4 <= width; j += 4, in += 16, out += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)in);
+		const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+		const __m128i src0 = _mm_unpacklo_epi8(src, zero), src1 = _mm_unpackhi_epi8(src, zero);
+		const __m128i dst0 = _mm_unpacklo_epi8(dst, zero), dst1 = _mm_unpackhi_epi8(dst, zero);
+
+		// The subtrahend never exceeds the target, so there is nothing to clamp
+		const __m128i res0 = _mm_sub_epi16(dst0, _mm_mulhi_epu16(_mm_mullo_epi16(src0, dst0), broadcastAlpha(src0)));
+		const __m128i res1 = _mm_sub_epi16(dst1, _mm_mulhi_epu16(_mm_mullo_epi16(src1, dst1), broadcastAlpha(src1)));
+		const __m128i res = _mm_packus_epi16(res0, res1);
+
+		const __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), zero), alphaMask);
+		_mm_storeu_si128((__m128i *)out, selectPixels(keep, dst, res));
+	}
+	return j;
+}
+
+static uint32 blendMultiplyRow(const byte *in, byte *out, uint32 width) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32(0xFF << (kAIndex * 8));
+
+	uint32 j = 0;
+	for (; j + 4 <= width; j += 4, in += 16, out += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)in);
+		const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+		const __m128i src0 = _mm_unpacklo_epi8(src, zero), src1 = _mm_unpackhi_epi8(src, zero);
+		const __m128i dst0 = _mm_unpacklo_epi8(dst, zero), dst1 = _mm_unpackhi_epi8(dst, zero);
+
+		const __m128i res0 = _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(_mm_mullo_epi16(src0, broadcastAlpha(src0)), 8), dst0), 8);
+		const __m128i res1 = _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(_mm_mullo_epi16(src1, broadcastAlpha(src1)), 8), dst1), 8);
+		const __m128i res = _mm_packus_epi16(res0, res1);
+
+		const __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), zero), alphaMask);
+		_mm_storeu_si128((__m128i *)out, selectPixels(keep, dst, res));
+	}
+	return j;
+}
+
+#elif defined(USE_NEON_BLIT)
+
+// (x * y) >> 16 for 16-bit lanes
+static inline uint16x8_t mulHi(uint16x8_t x, uint16x8_t y) {
+	return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(x), vget_low_u16(y)), 16),
+	                    vshrn_n_u32(vmull_u16(vget_high_u16(x), vget_high_u16(y)), 16));
+}
+
+static uint32 blendAlphaRow(const byte *in, byte *out, uint32 width) {
+	static const int channels[3] = { kRIndex, kGIndex, kBIndex };
+
+	uint32 j = 0;
+	for (; j + 8 <= width; j += 8, in += 32, out += 32) {
+		const uint8x8x4_t src = vld4_u8(in);
+		const uint8x8x4_t dst = vld4_u8(out);
+		const uint8x8_t a = src.val[kAIndex];
+		const uint8x8_t na = vmvn_u8(a);
+		const uint8x8_t draw = vtst_u8(a, a);
+
+		uint8x8x4_t res;
+		for (int c = 0; c < 3; c++) {
+			const int i = channels[c];
+			res.val[i] = vshrn_n_u16(vmlal_u8(vmull_u8(src.val[i], a), dst.val[i], na), 8);
+			res.val[i] = vbsl_u8(draw, res.val[i], dst.val[i]);
+		}
+		res.val[kAIndex] = vorr_u8(dst.val[kAIndex], draw);
+		vst4_u8(out, res);
+	}
+	return j;
+}
+
+static uint32 blendAlphaColorRow(const byte *in, byte *out, uint32 width, byte ca, byte cr, byte cg, byte cb) {
+	static const int channels[3] = { kRIndex, kGIndex, kBIndex };
+	const uint16 mod[3] = { cr, cg, cb };
+
+	uint32 j = 0;
+	for (; j + 8 <= width; j += 8, in += 32, out += 32) {
+		const uint8x8x4_t src = vld4_u8(in);
+		const uint8x8x4_t dst = vld4_u8(out);
+		const uint8x8_t ina = vshrn_n_u16(vmull_u8(src.val[kAIndex], vdup_n_u8(ca)), 8);
+		const uint8x8_t nina = vmvn_u8(ina);
+		const uint8x8_t draw = vtst_u8(ina, ina);
+
+		uint8x8x4_t res;
+		for (int c = 0; c < 3; c++) {
+			const int i = channels[c];
+			const uint8x8_t keep = vshrn_n_u16(vmull_u8(dst.val[i], nina), 8);
+			const uint8x8_t add = vmovn_u16(mulHi(vmull_u8(src.val[i], ina), vdupq_n_u16(mod[c])));
+			res.val[i] = vbsl_u8(draw, vadd_u8(keep, add), dst.val[i]);
+		}
+		res.val[kAIndex] = vorr_u8(dst.val[kAIndex], draw);
+		vst4_u8(out, res);
+	}
+	return j;
+}
+
+static uint32 blendAdditiveRow(const byte *in, byte *out, uint32 width) {
+	static const int channels[3] = { kRIndex, kGIndex, kBIndex };
+
+	uint32 j = 0;
+	for (; j + 8 <= width; j += 8, in += 32, out += 32) {
+		const uint8x8x4_t src = vld4_u8(in);
+		uint8x8x4_t res = vld4_u8(out);
+		const uint8x8_t a = src.val[kAIndex];
+		const uint8x8_t draw = vtst_u8(a, a);
+
+		for (int c = 0; c < 3; c++) {
+			const int i = channels[c];
+			const uint8x8_t sum = vqadd_u8(res.val[i], vshrn_n_u16(vmull_u8(src.val[i], a), 8));
+			res.val[i] = vbsl_u8(draw, sum, res.val[i]);
+		}
+		vst4_u8(out, res);
+	}
+	return j;
+}
+
+static uint32 blendSubtractiveRow(const byte *in, byte *out, uint32 width) {
+	static const int channels[3] = { kRIndex, kGIndex, kBIndex };
+
+	uint32 j = 0;
+	for (; j + 8 <= width; j += 8, in += 32, out += 32) {
+		const uint8x8x4_t src = vld4_u8(in);
+		uint8x8x4_t res = vld4_u8(out);
+		const uint8x8_t a = src.val[kAIndex];
+		const uint8x8_t draw = vtst_u8(a, a);
+
+		for (int c = 0; c < 3; c++) {
+			const int i = channels[c];
+			const uint8x8_t sub = vmovn_u16(mulHi(vmull_u8(src.val[i], res.val[i]), vmovl_u8(a)));
+			res.val[i] = vbsl_u8(draw, vsub_u8(res.val[i], sub), res.val[i]);
+		}
+		vst4_u8(out, res);
+	}
+	return j;
+}
+
+static uint32 blendMultiplyRow(const byte *in, byte *out, uint32 width) {
+	static const int channels[3] = { kRIndex, kGIndex, kBIndex };
+
+	uint32 j = 0;
+	for (; j + 8 <= width; j += 8, in += 32, out += 32) {
+		const uint8x8x4_t src = vld4_u8(in);
+		uint8x8x4_t res = vld4_u8(out);
+		const uint8x8_t a = src.val[kAIndex];
+		const uint8x8_t draw = vtst_u8(a, a);
+
+		for (int c = 0; c < 3; c++) {
+			const int i = channels[c];
+			const uint8x8_t mul = vshrn_n_u16(vmull_u8(vshrn_n_u16(vmull_u8(src.val[i], a), 8), res.val[i]), 8);
+			res.val[i] = vbsl_u8(draw, mul, res.val[i]);
+		}
+		vst4_u8(out, res);
+	}
+	return j;
+}
+
+#else
+
+// Without a vector unit the scalar loops handle every pixel
+static inline uint32 blendAlphaRow(const byte *, byte *, uint32) { return 0; }
+static inline uint32 blendAlphaColorRow(const byte *, byte *, uint32, byte, byte, byte, byte) { return 0; }
+static inline uint32 blendAdditiveRow(const byte *, byte *, uint32) { return 0; }
+static inline uint32 blendSubtractiveRow(const byte *, byte *, uint32) { return 0; }
+static inline uint32 blendMultiplyRow(const byte *, byte *, uint32) { return 0; }
+
+#endif
+
 /**
  * Optimized version of doBlit to be used with alpha blended blitting
  * @param ino a pointer to the input surface
@@ -149,7 +425,13 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+			if (inStep == 4) {
+				j = blendAlphaRow(in, out, width);
+				in += j * 4;
+				out += j * 4;
+			}
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kAIndex] = 255;
@@ -174,7 +456,13 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+			if (inStep == 4) {
+				j = blendAlphaColorRow(in, out, width, ca, cr, cg, cb);
+				in += j * 4;
+				out += j * 4;
+			}
+			for (; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
@@ -210,7 +498,13 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+			if (inStep == 4) {
+				j = blendAdditiveRow(in, out, width);
+				in += j * 4;
+				out += j * 4;
+			}
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
@@ -277,7 +571,13 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+			if (inStep == 4) {
+				j = blendSubtractiveRow(in, out, width);
+				in += j * 4;
+				out += j * 4;
+			}
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
@@ -341,7 +641,13 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = 0;
+			if (inStep == 4) {
+				j = blendMultiplyRow(in, out, width);
+				in += j * 4;
+				out += j * 4;
+			}
+			for (; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
@@ -774,6 +1080,154 @@ systems.
 
 struct tColorRGBA { byte r; byte g; byte b; byte a; };
 
+/*
+ * Bilinear scaling in scaleT() is done in two passes: interpolateRow()
+ * resamples one source row horizontally to the target width and blendRows()
+ * mixes two such rows with the vertical weight of the target row. Target rows
+ * sampling the same pair of source rows (any upscale) reuse the horizontal
+ * pass. Every channel is computed as c0 + (((c1 - c0) * e) >> 16), with e the
+ * 16-bit fractional position, which is bit-exact with the vector code: the
+ * vectors use a signed 16-bit high multiply and add back (c1 - c0) where the
+ * top bit of e was taken for a sign.
+ */
+static inline byte lerpChannel(byte c0, byte c1, int e) {
+	return (((c1 - c0) * e) >> 16) + c0;
+}
+
+#if defined(USE_SSE2_BLIT)
+
+static inline __m128i lerpChannels(__m128i c0, __m128i c1, __m128i e) {
+	const __m128i d = _mm_sub_epi16(c1, c0);
+	const __m128i hi = _mm_add_epi16(_mm_mulhi_epi16(d, e), _mm_and_si128(d, _mm_srai_epi16(e, 15)));
+	return _mm_add_epi16(c0, hi);
+}
+
+static inline __m128i loadPixelPair(const uint32 *src, int x0, int x1) {
+	return _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(src[x0]), _mm_cvtsi32_si128(src[x1])), _mm_setzero_si128());
+}
+
+static int interpolateRowFast(const uint32 *src, const int *sax, uint32 *dst, int dstW, int lastX) {
+	int x = 0;
+	for (; x + 4 <= dstW; x += 4) {
+		__m128i res[2];
+		for (int i = 0; i < 2; i++) {
+			const int s0 = sax[x + 2 * i], s1 = sax[x + 2 * i + 1];
+			const int x0 = s0 >> 16, x1 = s1 >> 16;
+			const __m128i c0 = loadPixelPair(src, x0, x1);
+			const __m128i c1 = loadPixelPair(src, x0 < lastX ? x0 + 1 : x0, x1 < lastX ? x1 + 1 : x1);
+			const __m128i e = _mm_unpacklo_epi64(_mm_set1_epi16((int16)(s0 & 0xffff)), _mm_set1_epi16((int16)(s1 & 0xffff)));
+			res[i] = lerpChannels(c0, c1, e);
+		}
+		_mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(res[0], res[1]));
+	}
+	return x;
+}
+
+static int blendRowsFast(const uint32 *row0, const uint32 *row1, uint32 *dst, int dstW, int ey) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i e = _mm_set1_epi16((int16)ey);
+
+	int x = 0;
+	for (; x + 4 <= dstW; x += 4) {
+		const __m128i p0 = _mm_loadu_si128((const __m128i *)(row0 + x));
+		const __m128i p1 = _mm_loadu_si128((const __m128i *)(row1 + x));
+		const __m128i lo = lerpChannels(_mm_unpacklo_epi8(p0, zero), _mm_unpacklo_epi8(p1, zero), e);
+		const __m128i hi = lerpChannels(_mm_unpackhi_epi8(p0, zero), _mm_unpackhi_epi8(p1, zero), e);
+		_mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(lo, hi));
+	}
+	return x;
+}
+
+#elif defined(USE_NEON_BLIT)
+
+static inline int16x8_t lerpChannels(int16x8_t c0, int16x8_t c1, int16x8_t e) {
+	const int16x8_t d = vsubq_s16(c1, c0);
+	const int16x8_t hi = vcombine_s16(vshrn_n_s32(vmull_s16(vget_low_s16(d), vget_low_s16(e)), 16),
+	                                  vshrn_n_s32(vmull_s16(vget_high_s16(d), vget_high_s16(e)), 16));
+	return vaddq_s16(c0, vaddq_s16(hi, vandq_s16(d, vshrq_n_s16(e, 15))));
+}
+
+static inline int16x8_t widenPixels(uint8x8_t p) {
+	return vreinterpretq_s16_u16(vmovl_u8(p));
+}
+
+static inline uint8x8_t narrowPixels(int16x8_t p) {
+	return vmovn_u16(vreinterpretq_u16_s16(p));
+}
+
+static inline int16x8_t loadPixelPair(const uint32 *src, int x0, int x1) {
+	return widenPixels(vreinterpret_u8_u32(vset_lane_u32(src[x1], vdup_n_u32(src[x0]), 1)));
+}
+
+static int interpolateRowFast(const uint32 *src, const int *sax, uint32 *dst, int dstW, int lastX) {
+	int x = 0;
+	for (; x + 2 <= dstW; x += 2) {
+		const int s0 = sax[x], s1 = sax[x + 1];
+		const int x0 = s0 >> 16, x1 = s1 >> 16;
+		const int16x8_t c0 = loadPixelPair(src, x0, x1);
+		const int16x8_t c1 = loadPixelPair(src, x0 < lastX ? x0 + 1 : x0, x1 < lastX ? x1 + 1 : x1);
+		const int16x8_t e = vcombine_s16(vdup_n_s16((int16)(s0 & 0xffff)), vdup_n_s16((int16)(s1 & 0xffff)));
+		vst1_u8((uint8 *)(dst + x), narrowPixels(lerpChannels(c0, c1, e)));
+	}
+	return x;
+}
+
+static int blendRowsFast(const uint32 *row0, const uint32 *row1, uint32 *dst, int dstW, int ey) {
+	const int16x8_t e = vdupq_n_s16((int16)ey);
+
+	int x = 0;
+	for (; x + 4 <= dstW; x += 4) {
+		const uint8x16_t p0 = vld1q_u8((const uint8 *)(row0 + x));
+		const uint8x16_t p1 = vld1q_u8((const uint8 *)(row1 + x));
+		const int16x8_t lo = lerpChannels(widenPixels(vget_low_u8(p0)), widenPixels(vget_low_u8(p1)), e);
+		const int16x8_t hi = lerpChannels(widenPixels(vget_high_u8(p0)), widenPixels(vget_high_u8(p1)), e);
+		vst1q_u8((uint8 *)(dst + x), vcombine_u8(narrowPixels(lo), narrowPixels(hi)));
+	}
+	return x;
+}
+
+#else
+
+static inline int interpolateRowFast(const uint32 *, const int *, uint32 *, int, int) { return 0; }
+static inline int blendRowsFast(const uint32 *, const uint32 *, uint32 *, int, int) { return 0; }
+
+#endif
+
+/**
+ * Horizontally resample a source row for bilinear scaling.
+ * @param src the source row
+ * @param sax the 16.16 source position of each target pixel
+ * @param dst the target row, dstW pixels
+ * @param lastX the index of the last pixel in the source row
+ */
+static void interpolateRow(const uint32 *src, const int *sax, uint32 *dst, int dstW, int lastX) {
+	for (int x = interpolateRowFast(src, sax, dst, dstW, lastX); x < dstW; x++) {
+		const int cx = sax[x] >> 16;
+		const int ex = sax[x] & 0xffff;
+		const byte *c0 = (const byte *)(src + cx);
+		const byte *c1 = (const byte *)(src + (cx < lastX ? cx + 1 : cx));
+		byte *out = (byte *)(dst + x);
+		for (int i = 0; i < 4; i++) {
+			out[i] = lerpChannel(c0[i], c1[i], ex);
+		}
+	}
+}
+
+/**
+ * Vertically mix two horizontally resampled rows.
+ * @param ey the 16-bit fractional position between row0 and row1
+ */
+static void blendRows(const uint32 *row0, const uint32 *row1, uint32 *dst, int dstW, int ey) {
+	for (int x = blendRowsFast(row0, row1, dst, dstW, ey); x < dstW; x++) {
+		const byte *c0 = (const byte *)(row0 + x);
+		const byte *c1 = (const byte *)(row1 + x);
+		byte *out = (byte *)(dst + x);
+		for (int i = 0; i < 4; i++) {
+			out[i] = lerpChannel(c0[i], c1[i], ey);
+		}
+	}
+}
+
 template <TFilteringMode filteringMode>
 TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transform) const {
 
@@ -904,9 +1358,6 @@ TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight
 	if (filteringMode == FILTER_BILINEAR) {
 		assert(format.bytesPerPixel == 4);
 
-		bool flipx = false, flipy = false; // TODO: See mirroring comment in RenderTicket ctor
-
-
 		int *sax = new int[dstW + 1];
 		int *say = new int[dstH + 1];
 		assert(sax && say);
@@ -951,100 +1402,39 @@ TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight
 			}
 		}
 
-		const tColorRGBA *sp = (const tColorRGBA *) getBasePtr(0, 0);
-		tColorRGBA *dp = (tColorRGBA *) target->getBasePtr(0, 0);
-		int spixelgap = srcW;
-
-		if (flipx) {
-			sp += spixelw;
-		}
-		if (flipy) {
-			sp += spixelgap * spixelh;
-		}
+		/*
+		 * Resample row by row, keeping the two horizontally interpolated
+		 * source rows around for the next target row
+		 */
+		uint32 *rowBuf = new uint32[dstW * 2];
+		uint32 *row0 = rowBuf;
+		uint32 *row1 = rowBuf + dstW;
+		int row0Y = -1;
+		int row1Y = -1;
 
-		csay = say;
 		for (int y = 0; y < dstH; y++) {
-			const tColorRGBA *csp = sp;
-			csax = sax;
-			for (int x = 0; x < dstW; x++) {
-				/*
-				* Setup color source pointers
-				*/
-				int ex = (*csax & 0xffff);
-				int ey = (*csay & 0xffff);
-				int cx = (*csax >> 16);
-				int cy = (*csay >> 16);
-
-				const tColorRGBA *c00, *c01, *c10, *c11;
-				c00 = sp;
-				c01 = sp;
-				c10 = sp;
-				if (cy < spixelh) {
-					if (flipy) {
-						c10 -= spixelgap;
-					} else {
-						c10 += spixelgap;
-					}
-				}
-				c11 = c10;
-				if (cx < spixelw) {
-					if (flipx) {
-						c01--;
-						c11--;
-					} else {
-						c01++;
-						c11++;
-					}
-				}
-
-				/*
-				* Draw and interpolate colors
-				*/
-				int t1, t2;
-				t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
-				t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
-				dp->r = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
-				t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
-				dp->g = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
-				t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
-				dp->b = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
-				t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
-				dp->a = (((t2 - t1) * ey) >> 16) + t1;
-
-				/*
-				* Advance source pointer x
-				*/
-				int *salastx = csax;
-				csax++;
-				int sstepx = (*csax >> 16) - (*salastx >> 16);
-				if (flipx) {
-					sp -= sstepx;
+			int cy = say[y] >> 16;
+			int ey = say[y] & 0xffff;
+			int cy1 = (cy < spixelh) ? cy + 1 : cy;
+
+			if (row0Y != cy) {
+				if (row1Y == cy) {
+					SWAP(row0, row1);
+					SWAP(row0Y, row1Y);
 				} else {
-					sp += sstepx;
+					interpolateRow((const uint32 *)getBasePtr(0, cy), sax, row0, dstW, spixelw);
+					row0Y = cy;
 				}
-
-				/*
-				* Advance destination pointer x
-				*/
-				dp++;
 			}
-			/*
-			* Advance source pointer y
-			*/
-			int *salasty = csay;
-			csay++;
-			int sstepy = (*csay >> 16) - (*salasty >> 16);
-			sstepy *= spixelgap;
-			if (flipy) {
-				sp = csp - sstepy;
-			} else {
-				sp = csp + sstepy;
+			if (row1Y != cy1) {
+				interpolateRow((const uint32 *)getBasePtr(0, cy1), sax, row1, dstW, spixelw);
+				row1Y = cy1;
 			}
+
+			blendRows(row0, row1, (uint32 *)target->getBasePtr(0, y), dstW, ey);
 		}
 
+		delete[] rowBuf;
 		delete[] sax;
 		delete[] say;
 
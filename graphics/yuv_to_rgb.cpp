@@ -83,6 +83,7 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/endian.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
@@ -192,6 +193,298 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+/*
+ * Row based conversion for platforms with a vector unit. The vector kernels
+ * compute the chroma offsets with 15-bit fixed point coefficients instead of
+ * looking them up, add them to the luminance, clamp, and pack eight pixels at
+ * a time into the destination format. For every chroma value the fixed point
+ * products truncate to the same offsets as the color tables, so the results
+ * are bit-exact with the lookup tables, which also finish off rows whose
+ * width isn't a multiple of eight.
+ */
+#if defined(__SSE2__)
+#define USE_SSE2_YUV
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define USE_NEON_YUV
+#include <arm_neon.h>
+#endif
+
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+
+// The coefficients of the color table, times 32768
+static const uint16 kCrRCoeff = 45919; // 0.419 / 0.299
+static const uint16 kCrGCoeff = 23383; // 0.299 / 0.419
+static const uint16 kCbGCoeff = 11286; // 0.114 / 0.331
+static const uint16 kCbBCoeff = 58111; // 0.587 / 0.331
+
+// The ITU scale maps [16, 235] to [0, 255]: x * 255 / 219 equals
+// x + ((x * kITUScale) >> 16) for all x in [0, 219].
+static const uint16 kITUScale = 10776;
+
+#if defined(USE_SSE2_YUV)
+
+// (x * coeff) / 32768, rounded towards zero like the float to int16
+// conversion of the color table
+static inline __m128i mulCoeff(__m128i x, __m128i coeff) {
+	const __m128i sign = _mm_srai_epi16(x, 15);
+	const __m128i abs = _mm_sub_epi16(_mm_xor_si128(x, sign), sign);
+	const __m128i res = _mm_mulhi_epu16(_mm_slli_epi16(abs, 1), coeff);
+	return _mm_sub_epi16(_mm_xor_si128(res, sign), sign);
+}
+
+static inline __m128i clampChannel(__m128i y, __m128i off, __m128i lo, __m128i hi, bool itu) {
+	__m128i c = _mm_min_epi16(_mm_max_epi16(_mm_add_epi16(y, off), lo), hi);
+	if (itu) {
+		c = _mm_sub_epi16(c, lo);
+		c = _mm_add_epi16(c, _mm_mulhi_epu16(c, _mm_set1_epi16((int16)kITUScale)));
+	}
+	return c;
+}
+
+static inline void storePixels(byte *dst, const byte *ySrc, __m128i rOff, __m128i gOff, __m128i bOff, const PixelFormat &format, bool itu) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = _mm_set1_epi16(itu ? 16 : 0);
+	const __m128i hi = _mm_set1_epi16(itu ? 235 : 255);
+	const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)ySrc), zero);
+	const __m128i r = _mm_srl_epi16(clampChannel(y, rOff, lo, hi, itu), _mm_cvtsi32_si128(format.rLoss));
+	const __m128i g = _mm_srl_epi16(clampChannel(y, gOff, lo, hi, itu), _mm_cvtsi32_si128(format.gLoss));
+	const __m128i b = _mm_srl_epi16(clampChannel(y, bOff, lo, hi, itu), _mm_cvtsi32_si128(format.bLoss));
+	const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+	const uint32 alpha = format.RGBToColor(0, 0, 0);
+
+	if (format.bytesPerPixel == 2) {
+		__m128i pix = _mm_or_si128(_mm_set1_epi16((int16)alpha), _mm_sll_epi16(r, rShift));
+		pix = _mm_or_si128(pix, _mm_or_si128(_mm_sll_epi16(g, gShift), _mm_sll_epi16(b, bShift)));
+		_mm_storeu_si128((__m128i *)dst, pix);
+	} else {
+		const __m128i a32 = _mm_set1_epi32(alpha);
+		__m128i pix0 = _mm_or_si128(a32, _mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift));
+		__m128i pix1 = _mm_or_si128(a32, _mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift));
+		pix0 = _mm_or_si128(pix0, _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift));
+		pix1 = _mm_or_si128(pix1, _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift));
+		pix0 = _mm_or_si128(pix0, _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift));
+		pix1 = _mm_or_si128(pix1, _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift));
+		_mm_storeu_si128((__m128i *)dst, pix0);
+		_mm_storeu_si128((__m128i *)(dst + 16), pix1);
+	}
+}
+
+static int convertRowsFast(byte *dst0, byte *dst1, const byte *y0, const byte *y1, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const PixelFormat &dstFormat, YUVToRGBManager::LuminanceScale scale) {
+	// A local copy, so the stores below can't alias it
+	const PixelFormat format = dstFormat;
+	const bool itu = (scale == YUVToRGBManager::kScaleITU);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+	const int bpp = format.bytesPerPixel;
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		__m128i u, v;
+		if (chromaShift) {
+			u = _mm_cvtsi32_si128(READ_UINT32(uSrc + (x >> 1)));
+			v = _mm_cvtsi32_si128(READ_UINT32(vSrc + (x >> 1)));
+			u = _mm_unpacklo_epi8(u, u);
+			v = _mm_unpacklo_epi8(v, v);
+		} else {
+			u = _mm_loadl_epi64((const __m128i *)(uSrc + x));
+			v = _mm_loadl_epi64((const __m128i *)(vSrc + x));
+		}
+		const __m128i cb = _mm_sub_epi16(_mm_unpacklo_epi8(u, zero), bias);
+		const __m128i cr = _mm_sub_epi16(_mm_unpacklo_epi8(v, zero), bias);
+
+		const __m128i rOff = mulCoeff(cr, _mm_set1_epi16((int16)kCrRCoeff));
+		const __m128i gOff = _mm_sub_epi16(zero, _mm_add_epi16(mulCoeff(cr, _mm_set1_epi16((int16)kCrGCoeff)), mulCoeff(cb, _mm_set1_epi16((int16)kCbGCoeff))));
+		const __m128i bOff = mulCoeff(cb, _mm_set1_epi16((int16)kCbBCoeff));
+
+		storePixels(dst0 + x * bpp, y0 + x, rOff, gOff, bOff, format, itu);
+		if (dst1)
+			storePixels(dst1 + x * bpp, y1 + x, rOff, gOff, bOff, format, itu);
+	}
+	return x;
+}
+
+#elif defined(USE_NEON_YUV)
+
+// (x * coeff) / 32768, rounded towards zero like the float to int16
+// conversion of the color table
+static inline int16x8_t mulCoeff(int16x8_t x, uint16 coeff) {
+	const uint16x8_t abs = vreinterpretq_u16_s16(vabsq_s16(x));
+	const uint16x4_t c = vdup_n_u16(coeff);
+	const int16x8_t res = vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(abs), c), 15),
+	                                                         vshrn_n_u32(vmull_u16(vget_high_u16(abs), c), 15)));
+	const int16x8_t sign = vshrq_n_s16(x, 15);
+	return vsubq_s16(veorq_s16(res, sign), sign);
+}
+
+static inline uint16x8_t clampChannel(int16x8_t y, int16x8_t off, bool itu) {
+	const int16x8_t lo = vdupq_n_s16(itu ? 16 : 0);
+	const int16x8_t hi = vdupq_n_s16(itu ? 235 : 255);
+	uint16x8_t c = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(vaddq_s16(y, off), lo), hi));
+	if (itu) {
+		c = vsubq_u16(c, vdupq_n_u16(16));
+		const uint16x4_t s = vdup_n_u16(kITUScale);
+		c = vaddq_u16(c, vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(c), s), 16),
+		                              vshrn_n_u32(vmull_u16(vget_high_u16(c), s), 16)));
+	}
+	return c;
+}
+
+static inline void storePixels(byte *dst, const byte *ySrc, int16x8_t rOff, int16x8_t gOff, int16x8_t bOff, const PixelFormat &format, bool itu) {
+	const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc)));
+	const uint16x8_t r = vshlq_u16(clampChannel(y, rOff, itu), vdupq_n_s16(-format.rLoss));
+	const uint16x8_t g = vshlq_u16(clampChannel(y, gOff, itu), vdupq_n_s16(-format.gLoss));
+	const uint16x8_t b = vshlq_u16(clampChannel(y, bOff, itu), vdupq_n_s16(-format.bLoss));
+	const uint32 alpha = format.RGBToColor(0, 0, 0);
+
+	if (format.bytesPerPixel == 2) {
+		uint16x8_t pix = vorrq_u16(vdupq_n_u16((uint16)alpha), vshlq_u16(r, vdupq_n_s16(format.rShift)));
+		pix = vorrq_u16(pix, vorrq_u16(vshlq_u16(g, vdupq_n_s16(format.gShift)), vshlq_u16(b, vdupq_n_s16(format.bShift))));
+		vst1q_u16((uint16 *)dst, pix);
+	} else {
+		const int32x4_t rShift = vdupq_n_s32(format.rShift);
+		const int32x4_t gShift = vdupq_n_s32(format.gShift);
+		const int32x4_t bShift = vdupq_n_s32(format.bShift);
+		uint32x4_t pix0 = vorrq_u32(vdupq_n_u32(alpha), vshlq_u32(vmovl_u16(vget_low_u16(r)), rShift));
+		uint32x4_t pix1 = vorrq_u32(vdupq_n_u32(alpha), vshlq_u32(vmovl_u16(vget_high_u16(r)), rShift));
+		pix0 = vorrq_u32(pix0, vshlq_u32(vmovl_u16(vget_low_u16(g)), gShift));
+		pix1 = vorrq_u32(pix1, vshlq_u32(vmovl_u16(vget_high_u16(g)), gShift));
+		pix0 = vorrq_u32(pix0, vshlq_u32(vmovl_u16(vget_low_u16(b)), bShift));
+		pix1 = vorrq_u32(pix1, vshlq_u32(vmovl_u16(vget_high_u16(b)), bShift));
+		vst1q_u32((uint32 *)dst, pix0);
+		vst1q_u32((uint32 *)(dst + 16), pix1);
+	}
+}
+
+static int convertRowsFast(byte *dst0, byte *dst1, const byte *y0, const byte *y1, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const PixelFormat &dstFormat, YUVToRGBManager::LuminanceScale scale) {
+	// A local copy, so the stores below can't alias it
+	const PixelFormat format = dstFormat;
+	const bool itu = (scale == YUVToRGBManager::kScaleITU);
+	const int16x8_t bias = vdupq_n_s16(128);
+	const int bpp = format.bytesPerPixel;
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		uint8x8_t u, v;
+		if (chromaShift) {
+			u = vreinterpret_u8_u32(vdup_n_u32(READ_UINT32(uSrc + (x >> 1))));
+			v = vreinterpret_u8_u32(vdup_n_u32(READ_UINT32(vSrc + (x >> 1))));
+			u = vzip_u8(u, u).val[0];
+			v = vzip_u8(v, v).val[0];
+		} else {
+			u = vld1_u8(uSrc + x);
+			v = vld1_u8(vSrc + x);
+		}
+		const int16x8_t cb = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u)), bias);
+		const int16x8_t cr = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v)), bias);
+
+		const int16x8_t rOff = mulCoeff(cr, kCrRCoeff);
+		const int16x8_t gOff = vnegq_s16(vaddq_s16(mulCoeff(cr, kCrGCoeff), mulCoeff(cb, kCbGCoeff)));
+		const int16x8_t bOff = mulCoeff(cb, kCbBCoeff);
+
+		storePixels(dst0 + x * bpp, y0 + x, rOff, gOff, bOff, format, itu);
+		if (dst1)
+			storePixels(dst1 + x * bpp, y1 + x, rOff, gOff, bOff, format, itu);
+	}
+	return x;
+}
+
+#endif
+
+/**
+ * Convert one row, or two rows sharing their chroma, with the vector kernel,
+ * and the rest of the row with the lookup tables.
+ *
+ * @param dst1        the second destination row, or 0 for a single row
+ * @param chromaShift 1 if the chroma is horizontally subsampled, else 0
+ */
+template<typename PixelInt>
+void convertYUVToRGBRows(byte *dst0, byte *dst1, const byte *y0, const byte *y1, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const YUVToRGBLookup *lookup, YUVToRGBManager::LuminanceScale scale, const int16 *colorTab) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int x = convertRowsFast(dst0, dst1, y0, y1, uSrc, vSrc, width, chromaShift, lookup->getFormat(), scale); x < width; x++) {
+		const byte u = uSrc[x >> chromaShift];
+		const byte v = vSrc[x >> chromaShift];
+		const int16 cr_r  = Cr_r_tab[v];
+		const int16 crb_g = Cr_g_tab[v] + Cb_g_tab[u];
+		const int16 cb_b  = Cb_b_tab[u];
+
+		const uint32 *L = &rgbToPix[y0[x]];
+		((PixelInt *)dst0)[x] = L[cr_r] | L[crb_g] | L[cb_b];
+		if (dst1) {
+			L = &rgbToPix[y1[x]];
+			((PixelInt *)dst1)[x] = L[cr_r] | L[crb_g] | L[cb_b];
+		}
+	}
+}
+
+template<typename PixelInt>
+void convertYUV444ToRGBRows(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, YUVToRGBManager::LuminanceScale scale, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	for (int h = 0; h < yHeight; h++) {
+		convertYUVToRGBRows<PixelInt>(dstPtr, 0, ySrc, 0, uSrc, vSrc, yWidth, 0, lookup, scale, colorTab);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<typename PixelInt>
+void convertYUV420ToRGBRows(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, YUVToRGBManager::LuminanceScale scale, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int halfHeight = yHeight >> 1;
+
+	for (int h = 0; h < halfHeight; h++) {
+		convertYUVToRGBRows<PixelInt>(dstPtr, dstPtr + dstPitch, ySrc, ySrc + yPitch, uSrc, vSrc, yWidth, 1, lookup, scale, colorTab);
+
+		dstPtr += dstPitch * 2;
+		ySrc += yPitch * 2;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<typename PixelInt>
+void convertYUV410ToRGBRows(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, YUVToRGBManager::LuminanceScale scale, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int quarterWidth = yWidth >> 2;
+	byte *uRow = new byte[yWidth * 2];
+	byte *vRow = uRow + yWidth;
+
+	for (int y = 0; y < yHeight; y++) {
+		// Bilinear interpolation of the chroma, as in convertYUV410ToRGB()
+		int yDiff = y & 3;
+		const byte *uQuad = uSrc + (y >> 2) * uvPitch;
+		const byte *vQuad = vSrc + (y >> 2) * uvPitch;
+
+		for (int x = 0; x < quarterWidth; x++) {
+			const int uA = uQuad[x], uB = uQuad[x + 1], uC = uQuad[x + uvPitch], uD = uQuad[x + uvPitch + 1];
+			const int vA = vQuad[x], vB = vQuad[x + 1], vC = vQuad[x + uvPitch], vD = vQuad[x + uvPitch + 1];
+
+			for (int xDiff = 0; xDiff < 4; xDiff++) {
+				uRow[x * 4 + xDiff] = (uA * (4 - xDiff) * (4 - yDiff) + uB * xDiff * (4 - yDiff) + uC * yDiff * (4 - xDiff) + uD * xDiff * yDiff) >> 4;
+				vRow[x * 4 + xDiff] = (vA * (4 - xDiff) * (4 - yDiff) + vB * xDiff * (4 - yDiff) + vC * yDiff * (4 - xDiff) + vD * xDiff * yDiff) >> 4;
+			}
+		}
+
+		convertYUVToRGBRows<PixelInt>(dstPtr, 0, ySrc, 0, uRow, vRow, yWidth, 0, lookup, scale, colorTab);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+
+	delete[] uRow;
+}
+
+#define USE_YUV_ROWS
+
+#endif
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
@@ -235,11 +528,18 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#ifdef USE_YUV_ROWS
+	if (dst->format.bytesPerPixel == 2)
+		convertYUV444ToRGBRows<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, scale, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	else
+		convertYUV444ToRGBRows<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, scale, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#else
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
 		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#endif
 }
 
 template<typename PixelInt>
@@ -291,11 +591,18 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#ifdef USE_YUV_ROWS
+	if (dst->format.bytesPerPixel == 2)
+		convertYUV420ToRGBRows<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, scale, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	else
+		convertYUV420ToRGBRows<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, scale, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#else
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
 		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#endif
 }
 
 #define READ_QUAD(ptr, prefix) \
@@ -376,11 +683,18 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#ifdef USE_YUV_ROWS
+	if (dst->format.bytesPerPixel == 2)
+		convertYUV410ToRGBRows<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, scale, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	else
+		convertYUV410ToRGBRows<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, scale, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#else
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
 		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+#endif
 }
 
 } // End of namespace Graphics
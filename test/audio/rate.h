@@ -0,0 +1,155 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/raw.h"
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "common/endian.h"
+#include "common/stream.h"
+
+class RateTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	// Deterministic pseudo random numbers; Common::RandomSource needs g_system
+	uint16 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	static int16 referenceMix(int16 out, int16 in, int vol) {
+		int val = out + (in * vol) / Audio::Mixer::kMaxMixerVolume;
+		return CLIP<int>(val, -32768, 32767);
+	}
+
+	// Mixes random samples with the copy converter and compares each output
+	// sample with the plain formula the mixer has always used.
+	void copyConverterTestTemplate(const bool isStereo, const bool reverseStereo, const int frames, const int volL, const int volR) {
+		_seed = frames;
+		const int samples = frames * (isStereo ? 2 : 1);
+
+		int16 *input = new int16[samples];
+		byte *raw = (byte *)malloc(samples * 2);
+		for (int i = 0; i < samples; ++i) {
+			// Hit the extremes every now and then, to test clamping
+			const uint16 r = nextRandom();
+			input[i] = ((r & 7) == 0) ? ((r & 8) ? 32767 : -32768) : (int16)nextRandom();
+			WRITE_LE_UINT16(raw + i * 2, input[i]);
+		}
+
+		int16 *output = new int16[frames * 2];
+		int16 *expected = new int16[frames * 2];
+		for (int i = 0; i < frames * 2; ++i)
+			output[i] = expected[i] = (int16)nextRandom();
+
+		for (int i = 0; i < frames; ++i) {
+			const int16 left = input[isStereo ? i * 2 : i];
+			const int16 right = input[isStereo ? i * 2 + 1 : i];
+			expected[i * 2 + (reverseStereo ? 1 : 0)] = referenceMix(expected[i * 2 + (reverseStereo ? 1 : 0)], left, volL);
+			expected[i * 2 + (reverseStereo ? 0 : 1)] = referenceMix(expected[i * 2 + (reverseStereo ? 0 : 1)], right, volR);
+		}
+
+		Common::SeekableReadStream *data = new Common::MemoryReadStream(raw, samples * 2, DisposeAfterUse::YES);
+		Audio::AudioStream *s = Audio::makeRawStream(data, 22050, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (isStereo ? Audio::FLAG_STEREO : 0));
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 22050, isStereo, reverseStereo);
+
+		TS_ASSERT_EQUALS(converter->flow(*s, output, frames, volL, volR), frames);
+		TS_ASSERT_EQUALS(memcmp(output, expected, frames * 2 * sizeof(int16)), 0);
+
+		delete converter;
+		delete s;
+		delete[] expected;
+		delete[] output;
+		delete[] input;
+	}
+
+
+	void sincConstantTestTemplate(const int inRate, const int outRate, const bool isStereo, const Audio::RateConverterQuality quality) {
+		const int frames = inRate / 10;
+		const int samples = frames * (isStereo ? 2 : 1);
+		byte *raw = (byte *)malloc(samples * 2);
+		for (int i = 0; i < samples; ++i)
+			WRITE_LE_UINT16(raw + i * 2, (isStereo && (i & 1)) ? -12345 : 10000);
+
+		Common::SeekableReadStream *data = new Common::MemoryReadStream(raw, samples * 2, DisposeAfterUse::YES);
+		Audio::AudioStream *s = Audio::makeRawStream(data, inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (isStereo ? Audio::FLAG_STEREO : 0));
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo, false, quality);
+
+		const int outFrames = (int)((int64)frames * outRate / inRate);
+		int16 *output = new int16[outFrames * 2];
+		memset(output, 0, outFrames * 2 * sizeof(int16));
+
+		// The filter delays the output by half its length, and the end of
+		// the input is not flushed, so allow for a few missing frames.
+		const int converted = converter->flow(*s, output, outFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		TS_ASSERT(converted > outFrames - 32 * outRate / inRate - 2);
+		TS_ASSERT(converted <= outFrames);
+
+		// Once the filter has settled, constant input must come out unchanged
+		for (int i = converted / 2; i < converted; ++i) {
+			TS_ASSERT_EQUALS(output[i * 2], 10000);
+			TS_ASSERT_EQUALS(output[i * 2 + 1], isStereo ? -12345 : 10000);
+		}
+
+		delete[] output;
+		delete converter;
+		delete s;
+	}
+
+public:
+	void test_copy_mono() {
+		copyConverterTestTemplate(false, false, 1000, 256, 256);
+		copyConverterTestTemplate(false, false, 1003, 127, 255);
+	}
+
+	void test_copy_stereo() {
+		copyConverterTestTemplate(true, false, 1000, 256, 256);
+		copyConverterTestTemplate(true, false, 1003, 17, 200);
+	}
+
+	void test_copy_reverse_stereo() {
+		copyConverterTestTemplate(true, true, 1000, 256, 0);
+		copyConverterTestTemplate(true, true, 1001, 99, 1);
+	}
+
+	void test_copy_loud() {
+		// Volumes above kMaxMixerVolume have to be handled as well
+		copyConverterTestTemplate(false, false, 1000, 1000, 300);
+		copyConverterTestTemplate(true, false, 1000, 300, 1000);
+	}
+
+	void test_sinc_upsample() {
+		sincConstantTestTemplate(11025, 44100, false, Audio::kRateConverterQualityMedium);
+		sincConstantTestTemplate(11025, 48000, true, Audio::kRateConverterQualityHigh);
+		sincConstantTestTemplate(22254, 44100, true, Audio::kRateConverterQualityMedium);
+	}
+
+	void test_sinc_downsample() {
+		sincConstantTestTemplate(44100, 22050, false, Audio::kRateConverterQualityHigh);
+		sincConstantTestTemplate(48000, 44100, true, Audio::kRateConverterQualityMedium);
+	}
+
+	void test_linear_end_of_stream() {
+		const int frames = 1000;
+		byte *raw = (byte *)calloc(frames, 2);
+
+		Common::SeekableReadStream *data = new Common::MemoryReadStream(raw, frames * 2, DisposeAfterUse::YES);
+		Audio::AudioStream *s = Audio::makeRawStream(data, 11025, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 44100, false);
+
+		int16 *output = new int16[frames * 8];
+		const int converted = converter->flow(*s, output, frames * 4, 256, 256);
+
+		// The converter has to stop when the input runs dry, and report the
+		// number of frames it actually produced.
+		TS_ASSERT(converted > frames * 4 - 8);
+		TS_ASSERT(converted <= frames * 4);
+		TS_ASSERT_EQUALS(converter->flow(*s, output, frames, 256, 256), 0);
+
+		delete[] output;
+		delete converter;
+		delete s;
+	}
+};
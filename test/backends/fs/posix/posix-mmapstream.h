@@ -0,0 +1,100 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/fs/posix/posix-mmapstream.h"
+#include "backends/fs/stdiostream.h"
+#include "common/config-manager.h"
+
+// sys/stat.h declares mkdir() and uses time_t, both of which
+// common/forbidden.h has already replaced at this point
+#undef mkdir
+#undef time_t
+#include <sys/stat.h>
+#include <stdio.h>
+
+class PosixMmapReadStreamTestSuite : public CxxTest::TestSuite {
+	static const char *const kShortFile;
+	static const char *const kLargeFile;
+	static const char *const kSaveDir;
+
+	static byte dataByte(uint32 pos) {
+		return (byte)(pos * 7 + (pos >> 12));
+	}
+
+	static void writeFile(const char *path, uint32 size, mode_t mode) {
+		remove(path);
+
+		StdioStream *stream = StdioStream::makeFromPath(path, true);
+		TS_ASSERT(stream);
+		for (uint32 i = 0; i < size; ++i)
+			stream->writeByte(dataByte(i));
+		stream->finalize();
+		TS_ASSERT(!stream->err());
+		delete stream;
+
+		TS_ASSERT_EQUALS(chmod(path, mode), 0);
+	}
+
+	public:
+	void test_short_file() {
+#ifdef HAS_POSIX_MMAP
+		writeFile(kShortFile, 1000, 0444);
+		TS_ASSERT(!PosixMmapReadStream::makeFromPath(kShortFile));
+		remove(kShortFile);
+#endif
+	}
+
+	void test_large_read_only_file() {
+#ifdef HAS_POSIX_MMAP
+		const uint32 size = MMAP_STREAM_THRESHOLD + 12345;
+		writeFile(kLargeFile, size, 0444);
+
+		PosixMmapReadStream *stream = PosixMmapReadStream::makeFromPath(kLargeFile);
+		TS_ASSERT(stream);
+		if (stream) {
+			TS_ASSERT_EQUALS(stream->size(), (int32)size);
+
+			bool match = true;
+			for (uint32 i = 0; i < size; ++i)
+				match &= stream->readByte() == dataByte(i);
+			TS_ASSERT(match);
+			TS_ASSERT_EQUALS(stream->pos(), (int32)size);
+
+			TS_ASSERT(stream->seek(size - 100));
+			TS_ASSERT_EQUALS(stream->readByte(), dataByte(size - 100));
+			delete stream;
+		}
+
+		remove(kLargeFile);
+#endif
+	}
+
+	void test_large_writable_file() {
+#ifdef HAS_POSIX_MMAP
+		writeFile(kLargeFile, MMAP_STREAM_THRESHOLD, 0644);
+		PosixMmapReadStream *stream = PosixMmapReadStream::makeFromPath(kLargeFile);
+		TS_ASSERT(stream);
+		delete stream;
+		remove(kLargeFile);
+#endif
+	}
+
+	void test_savegame() {
+#ifdef HAS_POSIX_MMAP
+		// Savegames could be rewritten while mapped
+		TS_ASSERT_EQUALS(mkdir(kSaveDir, 0755), 0);
+		ConfMan.set("savepath", kSaveDir, Common::ConfigManager::kApplicationDomain);
+
+		const Common::String path = Common::String(kSaveDir) + "/large.tmp";
+		writeFile(path.c_str(), MMAP_STREAM_THRESHOLD, 0644);
+		TS_ASSERT(!PosixMmapReadStream::makeFromPath(path));
+
+		ConfMan.removeKey("savepath", Common::ConfigManager::kApplicationDomain);
+		remove(path.c_str());
+		remove(kSaveDir);
+#endif
+	}
+};
+
+const char *const PosixMmapReadStreamTestSuite::kShortFile = "posix-mmapstream-short.tmp";
+const char *const PosixMmapReadStreamTestSuite::kLargeFile = "posix-mmapstream-large.tmp";
+const char *const PosixMmapReadStreamTestSuite::kSaveDir = "posix-mmapstream-saves";
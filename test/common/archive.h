@@ -0,0 +1,150 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/memstream.h"
+
+class ArchiveTestSuite : public CxxTest::TestSuite {
+	class TestArchive : public Common::Archive {
+	public:
+		Common::Array<Common::String> _files;
+		mutable int _lookups;
+		byte _id;
+
+		TestArchive(byte id = 0) : _lookups(0), _id(id) {}
+
+		bool hasFile(const Common::String &name) const {
+			++_lookups;
+			for (uint i = 0; i < _files.size(); ++i) {
+				if (_files[i].equalsIgnoreCase(name))
+					return true;
+			}
+			return false;
+		}
+
+		int listMembers(Common::ArchiveMemberList &list) const {
+			for (uint i = 0; i < _files.size(); ++i)
+				list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_files[i], this)));
+			return _files.size();
+		}
+
+		const Common::ArchiveMemberPtr getMember(const Common::String &name) const {
+			return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+		}
+
+		Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const {
+			if (!hasFile(name))
+				return nullptr;
+			return new Common::MemoryReadStream(&_id, 1);
+		}
+	};
+
+	public:
+	void test_priority() {
+		Common::SearchSet set;
+		TestArchive *low = new TestArchive(1);
+		TestArchive *high = new TestArchive(2);
+		low->_files.push_back("a");
+		low->_files.push_back("b");
+		high->_files.push_back("b");
+		set.add("low", low, 0);
+		set.add("high", high, 1);
+
+		TS_ASSERT(set.hasFile("a"));
+		TS_ASSERT(set.hasFile("b"));
+		TS_ASSERT(!set.hasFile("c"));
+
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("b");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->readByte(), 2);
+		delete stream;
+
+		set.setPriority("low", 2);
+		stream = set.createReadStreamForMember("b");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->readByte(), 1);
+		delete stream;
+	}
+
+	void test_cache() {
+		Common::SearchSet set;
+		TestArchive *archive = new TestArchive();
+		archive->_files.push_back("a");
+		set.add("archive", archive);
+
+		// Repeated lookups, including failing ones, are answered from the cache
+		TS_ASSERT(!set.hasFile("b"));
+		TS_ASSERT(set.hasFile("a"));
+		const int lookups = archive->_lookups;
+		TS_ASSERT(!set.hasFile("b"));
+		TS_ASSERT(set.hasFile("a"));
+		TS_ASSERT_EQUALS(archive->_lookups, lookups);
+
+		// Names differing in case only share their entry
+		TS_ASSERT(set.hasFile("A"));
+		TS_ASSERT(!set.hasFile("B"));
+		TS_ASSERT_EQUALS(archive->_lookups, lookups);
+
+		// Opening files uses the same entries, missing ones included
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("b");
+		TS_ASSERT(!stream);
+		TS_ASSERT_EQUALS(archive->_lookups, lookups);
+		TS_ASSERT(!set.getMember("b"));
+		TS_ASSERT_EQUALS(archive->_lookups, lookups);
+
+		// Adding an archive invalidates the cache for all of them
+		TestArchive *other = new TestArchive();
+		other->_files.push_back("b");
+		set.add("other", other);
+		stream = set.createReadStreamForMember("b");
+		TS_ASSERT(stream);
+		delete stream;
+		TS_ASSERT(set.hasFile("b"));
+
+		// So does removing one
+		set.remove("other");
+		TS_ASSERT(!set.createReadStreamForMember("b"));
+		TS_ASSERT(!set.hasFile("b"));
+	}
+
+	void test_nested() {
+		Common::SearchSet outer;
+		Common::SearchSet *inner = new Common::SearchSet();
+		outer.add("inner", inner);
+		TS_ASSERT(!outer.hasFile("a"));
+
+		// Changes of a contained search set are noticed as well
+		TestArchive *archive = new TestArchive();
+		archive->_files.push_back("a");
+		inner->add("archive", archive);
+		TS_ASSERT(outer.hasFile("a"));
+
+		// Also through more than one level
+		Common::SearchSet *innermost = new Common::SearchSet();
+		inner->add("innermost", innermost);
+		TS_ASSERT(!outer.hasFile("b"));
+		TestArchive *other = new TestArchive();
+		other->_files.push_back("b");
+		innermost->add("other", other);
+		TS_ASSERT(outer.hasFile("b"));
+
+		// A removed search set no longer reports to its former parent
+		Common::SearchSet detached;
+		outer.add("detached", &detached, 0, false);
+		outer.remove("detached");
+		detached.add("archive", new TestArchive());
+	}
+
+	void test_independent() {
+		Common::SearchSet set, unrelated;
+		TestArchive *archive = new TestArchive();
+		set.add("archive", archive);
+		TS_ASSERT(!set.hasFile("a"));
+
+		// Changes of other search sets keep the cache
+		const int lookups = archive->_lookups;
+		unrelated.add("archive", new TestArchive());
+		TS_ASSERT(!set.hasFile("a"));
+		TS_ASSERT_EQUALS(archive->_lookups, lookups);
+	}
+};
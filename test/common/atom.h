@@ -0,0 +1,66 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atom.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+
+class AtomTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_interning() {
+		Common::Atom a("RESOURCE.MAP");
+		Common::Atom b(Common::String("resource.map"));
+		Common::Atom c("resource.001");
+
+		TS_ASSERT(a == b);
+		TS_ASSERT(a != c);
+		TS_ASSERT_EQUALS(a.toString(), "RESOURCE.MAP");
+		TS_ASSERT_EQUALS(b.toString(), "RESOURCE.MAP");
+		TS_ASSERT_EQUALS(a.hash(), Common::hashit_lower("Resource.Map"));
+	}
+
+	void test_null() {
+		Common::Atom a, b("");
+		TS_ASSERT(a.empty());
+		TS_ASSERT(b.empty());
+		TS_ASSERT(a == b);
+		TS_ASSERT_EQUALS(a.toString(), "");
+		TS_ASSERT(!Common::Atom::find(""));
+	}
+
+	void test_find() {
+		TS_ASSERT(!Common::Atom::find("ATOMTEST.DAT"));
+		{
+			Common::Atom a("atomtest.dat");
+			const Common::Atom *b = Common::Atom::find("ATOMTEST.DAT");
+			TS_ASSERT(b);
+			TS_ASSERT(a == *b);
+
+			// Copies of the found atom are references of their own
+			Common::Atom c = *b;
+			a = Common::Atom();
+			TS_ASSERT(Common::Atom::find("atomtest.dat"));
+			TS_ASSERT(c == *Common::Atom::find("atomtest.dat"));
+		}
+		// Released once the last reference is gone
+		TS_ASSERT(!Common::Atom::find("ATOMTEST.DAT"));
+	}
+
+	void test_assign() {
+		Common::Atom a("first");
+		Common::Atom b("second");
+		a = b;
+		TS_ASSERT(a == b);
+		TS_ASSERT(!Common::Atom::find("first"));
+		TS_ASSERT_EQUALS(a.toString(), "second");
+	}
+
+	void test_hashmap_key() {
+		Common::HashMap<Common::Atom, int> map;
+		map[Common::Atom("Data.Hdr")] = 1;
+		map[Common::Atom("data.cab")] = 2;
+		TS_ASSERT_EQUALS(map.getVal(Common::Atom("DATA.HDR"), 0), 1);
+		TS_ASSERT_EQUALS(map.getVal(*Common::Atom::find("DATA.CAB"), 0), 2);
+		TS_ASSERT(!Common::Atom::find("data.1"));
+	}
+};
@@ -0,0 +1,56 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/lockfree-queue.h"
+
+class LockFreeQueueTestSuite : public CxxTest::TestSuite {
+public:
+	void test_push_pop() {
+		Common::LockFreeQueue<int, 4> queue;
+		int value = -1;
+
+		TS_ASSERT(queue.empty());
+		TS_ASSERT(!queue.pop(value));
+		TS_ASSERT_EQUALS(value, -1);
+
+		TS_ASSERT(queue.push(1));
+		TS_ASSERT(queue.push(2));
+		TS_ASSERT(!queue.empty());
+
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, 1);
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, 2);
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_full() {
+		Common::LockFreeQueue<int, 4> queue;
+		int value;
+
+		for (int i = 0; i < 4; ++i)
+			TS_ASSERT(queue.push(i));
+		TS_ASSERT(!queue.push(4));
+
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, 0);
+		TS_ASSERT(queue.push(4));
+
+		for (int i = 1; i <= 4; ++i) {
+			TS_ASSERT(queue.pop(value));
+			TS_ASSERT_EQUALS(value, i);
+		}
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_wrap_around() {
+		Common::LockFreeQueue<int, 2> queue;
+		int value;
+
+		for (int i = 0; i < 100; ++i) {
+			TS_ASSERT(queue.push(i));
+			TS_ASSERT(queue.pop(value));
+			TS_ASSERT_EQUALS(value, i);
+		}
+		TS_ASSERT(queue.empty());
+	}
+};
@@ -0,0 +1,176 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+	// Big enough to be streamed, and to span several seek checkpoints
+	static const uint32 kDataSize = 3 * 1024 * 1024;
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	byte *makeData() {
+		byte *data = new byte[kDataSize];
+		_seed = 1;
+		for (uint32 i = 0; i < kDataSize; ++i)
+			data[i] = 'a' + nextRandom() % 12;
+		return data;
+	}
+
+	/**
+	 * Deflate the data and compute its CRC, by taking the gzip stream
+	 * apart: it holds a 10 byte header, the raw deflate data, and a
+	 * trailer starting with the CRC.
+	 */
+	void deflate(const byte *data, Common::MemoryWriteStreamDynamic &deflated, uint32 &crc) {
+		Common::MemoryWriteStreamDynamic *buffer = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *stream = Common::wrapCompressedWriteStream(buffer);
+		stream->write(data, kDataSize);
+		stream->finalize();
+
+		const byte *gzip = buffer->getData();
+		const uint32 gzipSize = buffer->size();
+		deflated.write(gzip + 10, gzipSize - 18);
+		crc = READ_LE_UINT32(gzip + gzipSize - 8);
+		delete stream;
+	}
+
+	/** Build an archive holding a single member called "member". */
+	Common::Archive *makeArchive(const byte *data, bool compress, uint32 crcDelta) {
+		Common::MemoryWriteStreamDynamic deflated(DisposeAfterUse::YES);
+		uint32 crc;
+		deflate(data, deflated, crc);
+		crc += crcDelta;
+
+		const byte *memberData = compress ? deflated.getData() : data;
+		const uint32 memberSize = compress ? deflated.size() : kDataSize;
+		const uint16 method = compress ? 8 : 0;
+		const char name[] = "member";
+		const uint16 nameLength = sizeof(name) - 1;
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+
+		// Local file header
+		zip.writeUint32LE(0x04034B50);
+		zip.writeUint16LE(20);	// version needed
+		zip.writeUint16LE(0);	// flags
+		zip.writeUint16LE(method);
+		zip.writeUint32LE(0);	// time and date
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(memberSize);
+		zip.writeUint32LE(kDataSize);
+		zip.writeUint16LE(nameLength);
+		zip.writeUint16LE(0);	// extra field length
+		zip.write(name, nameLength);
+		zip.write(memberData, memberSize);
+
+		// Central directory
+		const uint32 centralDirOffset = zip.pos();
+		zip.writeUint32LE(0x02014B50);
+		zip.writeUint16LE(20);	// version made by
+		zip.writeUint16LE(20);	// version needed
+		zip.writeUint16LE(0);	// flags
+		zip.writeUint16LE(method);
+		zip.writeUint32LE(0);	// time and date
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(memberSize);
+		zip.writeUint32LE(kDataSize);
+		zip.writeUint16LE(nameLength);
+		zip.writeUint16LE(0);	// extra field length
+		zip.writeUint16LE(0);	// comment length
+		zip.writeUint16LE(0);	// disk number
+		zip.writeUint16LE(0);	// internal attributes
+		zip.writeUint32LE(0);	// external attributes
+		zip.writeUint32LE(0);	// offset of the local header
+		zip.write(name, nameLength);
+		const uint32 centralDirSize = zip.pos() - centralDirOffset;
+
+		// End of central directory
+		zip.writeUint32LE(0x06054B50);
+		zip.writeUint16LE(0);	// disk number
+		zip.writeUint16LE(0);	// disk with the central directory
+		zip.writeUint16LE(1);	// entries on this disk
+		zip.writeUint16LE(1);	// entries
+		zip.writeUint32LE(centralDirSize);
+		zip.writeUint32LE(centralDirOffset);
+		zip.writeUint16LE(0);	// comment length
+
+		return Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES));
+	}
+
+	void checkMember(bool compress) {
+		byte *data = makeData();
+		Common::Archive *archive = makeArchive(data, compress, 0);
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("member");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), (int32)kDataSize);
+
+		// Members stay readable after their archive is gone
+		delete archive;
+
+		byte *read = new byte[kDataSize];
+		TS_ASSERT_EQUALS(stream->read(read, kDataSize), kDataSize);
+		TS_ASSERT(memcmp(read, data, kDataSize) == 0);
+		TS_ASSERT(!stream->err());
+
+		// Seek back over a checkpoint, and read across the next one
+		const uint32 pos = kDataSize / 3 - 1000;
+		TS_ASSERT(stream->seek(pos));
+		TS_ASSERT_EQUALS(stream->read(read, kDataSize / 3), kDataSize / 3);
+		TS_ASSERT(memcmp(read, data + pos, kDataSize / 3) == 0);
+		TS_ASSERT(!stream->err());
+
+		delete[] read;
+		delete stream;
+		delete[] data;
+	}
+
+	void checkCRCError(bool compress) {
+		byte *data = makeData();
+		Common::Archive *archive = makeArchive(data, compress, 1);
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("member");
+		TS_ASSERT(stream);
+
+		// The CRC can only be known to be wrong at the end
+		byte *read = new byte[kDataSize];
+		TS_ASSERT_EQUALS(stream->read(read, kDataSize - 1), kDataSize - 1);
+		TS_ASSERT(!stream->err());
+		stream->readByte();
+		TS_ASSERT(stream->err());
+
+		delete[] read;
+		delete stream;
+		delete archive;
+		delete[] data;
+	}
+
+	public:
+	void test_stored() {
+#ifdef USE_ZLIB
+		checkMember(false);
+#endif
+	}
+
+	void test_deflated() {
+#ifdef USE_ZLIB
+		checkMember(true);
+#endif
+	}
+
+	void test_crc_error() {
+#ifdef USE_ZLIB
+		checkCRCError(false);
+		checkCRCError(true);
+#endif
+	}
+};
@@ -0,0 +1,87 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/zlib.h"
+
+class ZlibTestSuite : public CxxTest::TestSuite {
+	static const uint32 kDataSize = 1024 * 1024;
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	byte *makeData() {
+		// Mildly compressible data, so that there are many deflate blocks
+		byte *data = new byte[kDataSize];
+		_seed = 1;
+		for (uint32 i = 0; i < kDataSize; ++i)
+			data[i] = 'a' + nextRandom() % 12;
+		return data;
+	}
+
+	Common::SeekableReadStream *compress(const byte *data) {
+		Common::MemoryWriteStreamDynamic *buffer = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *stream = Common::wrapCompressedWriteStream(buffer);
+		stream->write(data, kDataSize);
+		stream->finalize();
+		byte *compressed = buffer->getData();
+		uint32 compressedSize = buffer->size();
+		delete stream;
+		return new Common::MemoryReadStream(compressed, compressedSize, DisposeAfterUse::YES);
+	}
+
+	public:
+	void test_read() {
+#ifdef USE_ZLIB
+		byte *data = makeData();
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(compress(data));
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), (int32)kDataSize);
+
+		byte *read = new byte[kDataSize];
+		TS_ASSERT_EQUALS(stream->read(read, kDataSize), kDataSize);
+		TS_ASSERT(memcmp(read, data, kDataSize) == 0);
+		TS_ASSERT(!stream->eos());
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+
+		delete[] read;
+		delete stream;
+		delete[] data;
+#endif
+	}
+
+	void test_seek() {
+#ifdef USE_ZLIB
+		byte *data = makeData();
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(compress(data));
+		TS_ASSERT(stream);
+
+		// Read everything once, then jump around in both directions
+		stream->skip(kDataSize);
+
+		byte buffer[256];
+		_seed = 42;
+		for (int i = 0; i < 100; ++i) {
+			const uint32 pos = (nextRandom() * 65536 + nextRandom()) % (kDataSize - sizeof(buffer));
+			TS_ASSERT(stream->seek(pos));
+			TS_ASSERT_EQUALS(stream->pos(), (int32)pos);
+			TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), sizeof(buffer));
+			TS_ASSERT(memcmp(buffer, data + pos, sizeof(buffer)) == 0);
+		}
+
+		// Back to the start, where the gzip header has to be parsed again
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), sizeof(buffer));
+		TS_ASSERT(memcmp(buffer, data, sizeof(buffer)) == 0);
+		TS_ASSERT(!stream->err());
+
+		delete stream;
+		delete[] data;
+#endif
+	}
+};
@@ -0,0 +1,109 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transform_cache.h"
+
+class TransformCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	// A sprite of the given size filled with one byte value
+	static Graphics::Surface *makeSurface(int w, int h, byte value) {
+		Graphics::Surface *surf = new Graphics::Surface();
+		surf->create(w, h, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		memset(surf->getPixels(), value, surf->pitch * surf->h);
+		return surf;
+	}
+
+	static void freeSurface(Graphics::Surface *surf) {
+		surf->free();
+		delete surf;
+	}
+
+	static Graphics::TransformCache::Key makeKey(const void *owner, int zoom) {
+		return Graphics::TransformCache::Key(owner, Common::Rect(0, 0, 10, 10), Graphics::TransformStruct(zoom, zoom, 0u), 10 * zoom / 100, 10 * zoom / 100, Graphics::FILTER_BILINEAR);
+	}
+
+public:
+	void test_find() {
+		int owner;
+		Graphics::TransformCache cache(1024 * 1024);
+		TS_ASSERT(!cache.find(makeKey(&owner, 200)));
+
+		Graphics::Surface *surf = makeSurface(20, 20, 0x42);
+		cache.insert(makeKey(&owner, 200), *surf);
+		TS_ASSERT_EQUALS(cache.getSize(), 20u * 20 * 4);
+
+		const Graphics::Surface *found = cache.find(makeKey(&owner, 200));
+		TS_ASSERT(found);
+		TS_ASSERT(found != surf);
+		TS_ASSERT_EQUALS(found->w, 20);
+		TS_ASSERT_EQUALS(found->h, 20);
+		TS_ASSERT_SAME_DATA(found->getPixels(), surf->getPixels(), 20 * 20 * 4);
+
+		TS_ASSERT(!cache.find(makeKey(&owner, 150)));
+		TS_ASSERT(!cache.find(Graphics::TransformCache::Key(&owner, Common::Rect(0, 0, 10, 10), Graphics::TransformStruct(200, 200, 0u), 20, 20, Graphics::FILTER_NEAREST)));
+		TS_ASSERT(!cache.find(Graphics::TransformCache::Key(&owner, Common::Rect(10, 0, 20, 10), Graphics::TransformStruct(200, 200, 0u), 20, 20, Graphics::FILTER_BILINEAR)));
+
+		// Blitting parameters don't change the transformed pixels
+		Graphics::TransformStruct blended(200, 200, Graphics::BLEND_ADDITIVE, 128, true, false);
+		TS_ASSERT(cache.find(Graphics::TransformCache::Key(&owner, Common::Rect(0, 0, 10, 10), blended, 20, 20, Graphics::FILTER_BILINEAR)));
+
+		freeSurface(surf);
+	}
+
+	void test_eviction() {
+		int owner;
+		// Room for three 10x10 sprites
+		Graphics::TransformCache cache(3 * 10 * 10 * 4);
+		Graphics::Surface *surf = makeSurface(10, 10, 0);
+
+		cache.insert(makeKey(&owner, 100), *surf);
+		cache.insert(makeKey(&owner, 101), *surf);
+		cache.insert(makeKey(&owner, 102), *surf);
+		TS_ASSERT_EQUALS(cache.getSize(), 3u * 10 * 10 * 4);
+
+		// Touch the oldest one, so the second one goes first
+		TS_ASSERT(cache.find(makeKey(&owner, 100)));
+		cache.insert(makeKey(&owner, 103), *surf);
+		TS_ASSERT_EQUALS(cache.getSize(), 3u * 10 * 10 * 4);
+		TS_ASSERT(cache.find(makeKey(&owner, 100)));
+		TS_ASSERT(!cache.find(makeKey(&owner, 101)));
+		TS_ASSERT(cache.find(makeKey(&owner, 102)));
+		TS_ASSERT(cache.find(makeKey(&owner, 103)));
+
+		// Replacing an entry doesn't count it twice
+		cache.insert(makeKey(&owner, 103), *surf);
+		TS_ASSERT_EQUALS(cache.getSize(), 3u * 10 * 10 * 4);
+		TS_ASSERT(cache.find(makeKey(&owner, 100)));
+
+		// Too large for the whole budget
+		Graphics::Surface *large = makeSurface(40, 10, 0);
+		cache.insert(makeKey(&owner, 400), *large);
+		TS_ASSERT(!cache.find(makeKey(&owner, 400)));
+		TS_ASSERT(cache.find(makeKey(&owner, 100)));
+
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.getSize(), 0u);
+		TS_ASSERT(!cache.find(makeKey(&owner, 100)));
+
+		freeSurface(surf);
+		freeSurface(large);
+	}
+
+	void test_invalidate() {
+		int owner1, owner2;
+		Graphics::TransformCache cache(1024 * 1024);
+		Graphics::Surface *surf = makeSurface(10, 10, 0);
+
+		cache.insert(makeKey(&owner1, 100), *surf);
+		cache.insert(makeKey(&owner2, 100), *surf);
+		cache.insert(makeKey(&owner1, 200), *surf);
+
+		cache.invalidate(&owner1);
+		TS_ASSERT(!cache.find(makeKey(&owner1, 100)));
+		TS_ASSERT(!cache.find(makeKey(&owner1, 200)));
+		TS_ASSERT(cache.find(makeKey(&owner2, 100)));
+		TS_ASSERT_EQUALS(cache.getSize(), 10u * 10 * 4);
+
+		freeSurface(surf);
+	}
+};
@@ -0,0 +1,215 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transparent_surface.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	// Deterministic pseudo random numbers; Common::RandomSource needs g_system
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	// Mostly transparent or opaque pixels, like real sprites
+	byte randomAlpha() {
+		byte r = nextRandom();
+		return r < 64 ? 0 : (r < 128 ? 255 : nextRandom());
+	}
+
+	void fill(Graphics::TransparentSurface &surf, bool sprite, int w = 37, int h = 5) {
+		surf.create(w, h, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		for (int y = 0; y < surf.h; y++) {
+			uint32 *pixel = (uint32 *)surf.getBasePtr(0, y);
+			for (int x = 0; x < surf.w; x++) {
+				byte a = sprite ? randomAlpha() : nextRandom();
+				pixel[x] = (nextRandom() << 24) | (nextRandom() << 16) | (nextRandom() << 8) | a;
+			}
+		}
+	}
+
+	// The scalar blend formulas, one pixel at a time, in 0xRRGGBBAA format
+	static uint32 referenceBlend(uint32 src, uint32 dst, uint32 color, Graphics::TSpriteBlendMode mode, Graphics::AlphaType alphaMode) {
+		uint32 in[4], out[4];
+		for (int c = 0; c < 4; c++) {
+			in[c] = (src >> (24 - 8 * c)) & 0xFF;
+			out[c] = (dst >> (24 - 8 * c)) & 0xFF;
+		}
+		const uint32 ca = color >> 24;
+		const uint32 mod[3] = { (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF };
+		const uint32 a = in[3];
+
+		if (color == 0xFFFFFFFF && mode == Graphics::BLEND_NORMAL && alphaMode == Graphics::ALPHA_OPAQUE) {
+			return src | 0xFF;
+		} else if (color == 0xFFFFFFFF && mode == Graphics::BLEND_NORMAL && alphaMode == Graphics::ALPHA_BINARY) {
+			return a ? (src | 0xFF) : dst;
+		}
+
+		for (int c = 0; c < 3; c++) {
+			const uint32 ina = a * ca >> 8;
+			switch (mode) {
+			case Graphics::BLEND_NORMAL:
+				if (color == 0xFFFFFFFF) {
+					if (a)
+						out[c] = (in[c] * a + out[c] * (255 - a)) >> 8;
+				} else if (ina) {
+					out[c] = (byte)((out[c] * (255 - ina) >> 8) + (in[c] * ina * mod[c] >> 16));
+				}
+				break;
+			case Graphics::BLEND_ADDITIVE:
+				if (color == 0xFFFFFFFF) {
+					if (a)
+						out[c] = MIN<uint32>((in[c] * a >> 8) + out[c], 255);
+				} else if (mod[c] != 255) {
+					out[c] = MIN<uint32>(out[c] + ((in[c] * mod[c] * ina) >> 16), 255);
+				} else {
+					out[c] = MIN<uint32>(out[c] + (in[c] * ina >> 8), 255);
+				}
+				break;
+			case Graphics::BLEND_SUBTRACTIVE:
+				if (color == 0xFFFFFFFF) {
+					if (a)
+						out[c] = MAX<int>(out[c] - ((in[c] * out[c]) * a >> 16), 0);
+				} else if (mod[c] != 255) {
+					out[c] = MAX<int>(out[c] - ((in[c] * mod[c] * out[c] * a) >> 24), 0);
+				} else {
+					out[c] = MAX<int>(out[c] - (in[c] * out[c] * a >> 16), 0);
+				}
+				break;
+			case Graphics::BLEND_MULTIPLY:
+				if (color == 0xFFFFFFFF) {
+					if (a)
+						out[c] = MIN<uint32>((in[c] * a >> 8) * out[c] >> 8, 255);
+				} else if (mod[c] != 255) {
+					out[c] = MIN<uint32>(out[c] * ((in[c] * mod[c] * ina) >> 16) >> 8, 255);
+				} else {
+					out[c] = MIN<uint32>(out[c] * (in[c] * ina >> 8) >> 8, 255);
+				}
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (mode == Graphics::BLEND_NORMAL && (color == 0xFFFFFFFF ? a : (a * ca >> 8)))
+			out[3] = 255;
+		else if (mode == Graphics::BLEND_SUBTRACTIVE && color != 0xFFFFFFFF)
+			out[3] = 255;
+
+		return (out[0] << 24) | (out[1] << 16) | (out[2] << 8) | out[3];
+	}
+
+	void checkBlit(Graphics::TSpriteBlendMode mode, Graphics::AlphaType alphaMode, uint32 color, int flipping) {
+		Graphics::TransparentSurface src, dst, expected;
+		fill(src, true);
+		fill(dst, false);
+		src.setAlphaMode(alphaMode);
+		expected.copyFrom(dst);
+
+		for (int y = 0; y < src.h; y++) {
+			for (int x = 0; x < src.w; x++) {
+				const int sx = (flipping & Graphics::FLIP_H) ? src.w - 1 - x : x;
+				const int sy = (flipping & Graphics::FLIP_V) ? src.h - 1 - y : y;
+				uint32 *pixel = (uint32 *)expected.getBasePtr(x, y);
+				*pixel = referenceBlend(*(const uint32 *)src.getBasePtr(sx, sy), *pixel, color, mode, alphaMode);
+			}
+		}
+
+		src.blit(dst, 0, 0, flipping, nullptr, color, -1, -1, mode);
+
+		for (int y = 0; y < dst.h; y++)
+			TS_ASSERT_SAME_DATA(dst.getBasePtr(0, y), expected.getBasePtr(0, y), dst.w * 4);
+
+		src.free();
+		dst.free();
+		expected.free();
+	}
+
+	// 16.16 source positions of each target pixel, as computed by scaleT
+	static void scalePositions(int *pos, int src, int dst) {
+		const int step = (int)(65536.0f * (float)(src - 1) / (float)(dst - 1));
+		int p = 0;
+		for (int i = 0; i < dst; i++) {
+			pos[i] = p;
+			p = MIN(p + step, (src << 16) - 1);
+		}
+	}
+
+	static byte referenceLerp(byte c0, byte c1, int e) {
+		return (((c1 - c0) * e) >> 16) + c0;
+	}
+
+	void checkScaleBilinear(int srcW, int srcH, int dstW, int dstH) {
+		Graphics::TransparentSurface src;
+		fill(src, true, srcW, srcH);
+
+		int *sax = new int[dstW];
+		int *say = new int[dstH];
+		scalePositions(sax, srcW, dstW);
+		scalePositions(say, srcH, dstH);
+
+		Graphics::TransparentSurface *dst = src.scaleT<Graphics::FILTER_BILINEAR>(dstW, dstH);
+		TS_ASSERT_EQUALS(dst->w, dstW);
+		TS_ASSERT_EQUALS(dst->h, dstH);
+
+		for (int y = 0; y < dstH; y++) {
+			const int cy = say[y] >> 16;
+			const int cy1 = cy < srcH - 1 ? cy + 1 : cy;
+			for (int x = 0; x < dstW; x++) {
+				const int cx = sax[x] >> 16;
+				const int cx1 = cx < srcW - 1 ? cx + 1 : cx;
+				const byte *c00 = (const byte *)src.getBasePtr(cx, cy);
+				const byte *c01 = (const byte *)src.getBasePtr(cx1, cy);
+				const byte *c10 = (const byte *)src.getBasePtr(cx, cy1);
+				const byte *c11 = (const byte *)src.getBasePtr(cx1, cy1);
+				const byte *out = (const byte *)dst->getBasePtr(x, y);
+				for (int c = 0; c < 4; c++) {
+					const byte t1 = referenceLerp(c00[c], c01[c], sax[x] & 0xffff);
+					const byte t2 = referenceLerp(c10[c], c11[c], sax[x] & 0xffff);
+					TS_ASSERT_EQUALS(out[c], referenceLerp(t1, t2, say[y] & 0xffff));
+				}
+			}
+		}
+
+		delete[] sax;
+		delete[] say;
+		dst->free();
+		delete dst;
+		src.free();
+	}
+
+public:
+	void test_scale_bilinear() {
+		_seed = 1;
+		checkScaleBilinear(37, 5, 37, 5);
+		checkScaleBilinear(37, 5, 113, 17);
+		checkScaleBilinear(64, 48, 21, 15);
+		checkScaleBilinear(16, 16, 23, 9);
+		checkScaleBilinear(2, 3, 7, 11);
+	}
+
+	void test_blend_modes() {
+		static const Graphics::TSpriteBlendMode modes[] = {
+			Graphics::BLEND_NORMAL, Graphics::BLEND_ADDITIVE, Graphics::BLEND_SUBTRACTIVE, Graphics::BLEND_MULTIPLY
+		};
+		static const Graphics::AlphaType alphaModes[] = {
+			Graphics::ALPHA_OPAQUE, Graphics::ALPHA_BINARY, Graphics::ALPHA_FULL
+		};
+		// Colour mods above 128 overflow int in the scalar subtractive blend
+		static const uint32 colors[] = { 0xFFFFFFFF, 0xFF80FF40, 0x7FFFFFFF, 0xC0204060 };
+
+		_seed = 1;
+		for (int m = 0; m < ARRAYSIZE(modes); m++) {
+			for (int a = 0; a < ARRAYSIZE(alphaModes); a++) {
+				for (int c = 0; c < ARRAYSIZE(colors); c++) {
+					checkBlit(modes[m], alphaModes[a], colors[c], Graphics::FLIP_NONE);
+					// The opaque fast path copies whole rows and ignores FLIP_H
+					if (alphaModes[a] != Graphics::ALPHA_OPAQUE)
+						checkBlit(modes[m], alphaModes[a], colors[c], Graphics::FLIP_H);
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,158 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/util.h"
+#include "graphics/yuv_to_rgb.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	// Deterministic pseudo random numbers; Common::RandomSource needs g_system
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	void fillPlane(byte *plane, int size) {
+		for (int i = 0; i < size; i++)
+			plane[i] = nextRandom();
+	}
+
+	static int clampChannel(int value, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		if (scale == Graphics::YUVToRGBManager::kScaleFull)
+			return CLIP(value, 0, 255);
+		return (CLIP(value, 16, 235) - 16) * 255 / 219;
+	}
+
+	// The conversion formula of the color tables, one pixel at a time
+	static uint32 referencePixel(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, byte y, byte u, byte v) {
+		const int16 cr = v - 128, cb = u - 128;
+		const int r = y + (int16)((0.419 / 0.299) * cr);
+		const int g = y + (int16)(-(0.299 / 0.419) * cr) + (int16)(-(0.114 / 0.331) * cb);
+		const int b = y + (int16)((0.587 / 0.331) * cb);
+		return format.RGBToColor(clampChannel(r, scale), clampChannel(g, scale), clampChannel(b, scale));
+	}
+
+	static uint32 getPixel(const Graphics::Surface &surf, int x, int y) {
+		if (surf.format.bytesPerPixel == 2)
+			return *(const uint16 *)surf.getBasePtr(x, y);
+		return *(const uint32 *)surf.getBasePtr(x, y);
+	}
+
+	// Convert a random frame with the given chroma subsampling and compare
+	// it with the reference
+	void checkConversion(int subsampling, const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		const int yPitch = width + 3;
+		const int uvWidth = width / subsampling + 1;
+		const int uvHeight = height / subsampling + 1;
+		const int uvPitch = uvWidth + 2;
+
+		byte *yPlane = new byte[yPitch * height];
+		byte *uPlane = new byte[uvPitch * uvHeight];
+		byte *vPlane = new byte[uvPitch * uvHeight];
+		fillPlane(yPlane, yPitch * height);
+		fillPlane(uPlane, uvPitch * uvHeight);
+		fillPlane(vPlane, uvPitch * uvHeight);
+
+		Graphics::Surface dst;
+		dst.create(width, height, format);
+
+		if (subsampling == 1)
+			YUVToRGBMan.convert444(&dst, scale, yPlane, uPlane, vPlane, width, height, yPitch, uvPitch);
+		else if (subsampling == 2)
+			YUVToRGBMan.convert420(&dst, scale, yPlane, uPlane, vPlane, width, height, yPitch, uvPitch);
+		else
+			YUVToRGBMan.convert410(&dst, scale, yPlane, uPlane, vPlane, width, height, yPitch, uvPitch);
+
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				byte u, v;
+				if (subsampling == 4) {
+					// Bilinear interpolation of the chroma
+					const int index = (y / 4) * uvPitch + x / 4;
+					const int xDiff = x & 3, yDiff = y & 3;
+					const int wA = (4 - xDiff) * (4 - yDiff), wB = xDiff * (4 - yDiff), wC = yDiff * (4 - xDiff), wD = xDiff * yDiff;
+					u = (uPlane[index] * wA + uPlane[index + 1] * wB + uPlane[index + uvPitch] * wC + uPlane[index + uvPitch + 1] * wD) >> 4;
+					v = (vPlane[index] * wA + vPlane[index + 1] * wB + vPlane[index + uvPitch] * wC + vPlane[index + uvPitch + 1] * wD) >> 4;
+				} else {
+					const int index = (y / subsampling) * uvPitch + x / subsampling;
+					u = uPlane[index];
+					v = vPlane[index];
+				}
+				TS_ASSERT_EQUALS(getPixel(dst, x, y), referencePixel(format, scale, yPlane[y * yPitch + x], u, v));
+			}
+		}
+
+		dst.free();
+		delete[] yPlane;
+		delete[] uPlane;
+		delete[] vPlane;
+	}
+
+	void checkFormats(int subsampling, int width, int height) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			checkConversion(subsampling, formats[f], Graphics::YUVToRGBManager::kScaleFull, width, height);
+			checkConversion(subsampling, formats[f], Graphics::YUVToRGBManager::kScaleITU, width, height);
+		}
+	}
+
+public:
+	// Every combination of chroma values, against every luminance value
+	void test_all_chroma() {
+		byte *yPlane = new byte[256 * 256];
+		byte *uPlane = new byte[256 * 256];
+		byte *vPlane = new byte[256 * 256];
+		for (int y = 0; y < 256; y++) {
+			for (int x = 0; x < 256; x++) {
+				yPlane[y * 256 + x] = x ^ y;
+				uPlane[y * 256 + x] = x;
+				vPlane[y * 256 + x] = y;
+			}
+		}
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		Graphics::Surface dst;
+		dst.create(256, 256, format);
+
+		for (int s = 0; s < 2; s++) {
+			const Graphics::YUVToRGBManager::LuminanceScale scale = s ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+			YUVToRGBMan.convert444(&dst, scale, yPlane, uPlane, vPlane, 256, 256, 256, 256);
+			for (int y = 0; y < 256; y++) {
+				for (int x = 0; x < 256; x++)
+					TS_ASSERT_EQUALS(getPixel(dst, x, y), referencePixel(format, scale, x ^ y, x, y));
+			}
+		}
+
+		dst.free();
+		delete[] yPlane;
+		delete[] uPlane;
+		delete[] vPlane;
+	}
+
+	void test_convert444() {
+		_seed = 1;
+		checkFormats(1, 37, 5);
+		checkFormats(1, 64, 3);
+	}
+
+	void test_convert420() {
+		_seed = 2;
+		checkFormats(2, 38, 6);
+		checkFormats(2, 64, 4);
+	}
+
+	void test_convert410() {
+		_seed = 3;
+		checkFormats(4, 36, 8);
+		checkFormats(4, 64, 4);
+	}
+};
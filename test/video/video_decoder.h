@@ -0,0 +1,284 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+// VideoDecoder needs g_system for the screen format and the playback clock
+class VideoDecoderTestSystem : public OSystem {
+public:
+	const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int) { return true; }
+	int getGraphicsMode() const { return 0; }
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	void initSize(uint, uint, const Graphics::PixelFormat *) {}
+	int16 getHeight() { return 0; }
+	int16 getWidth() { return 0; }
+	PaletteManager *getPaletteManager() { return 0; }
+	void copyRectToScreen(const void *, int, int, int, int, int) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32) {}
+	void updateScreen() {}
+	void setShakePos(int, int) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(); }
+	void clearOverlay() {}
+	void grabOverlay(void *, int) {}
+	void copyRectToOverlay(const void *, int, int, int, int, int) {}
+	int16 getOverlayHeight() { return 0; }
+	int16 getOverlayWidth() { return 0; }
+	bool showMouse(bool) { return false; }
+	void warpMouse(int, int) {}
+	void setMouseCursor(const void *, uint, uint, int, int, uint32, bool, const Graphics::PixelFormat *) {}
+	uint32 getMillis(bool) { return 0; }
+	void delayMillis(uint) {}
+	void getTimeAndDate(TimeDate &) const {}
+	MutexRef createMutex() { return 0; }
+	void lockMutex(MutexRef) {}
+	void unlockMutex(MutexRef) {}
+	void deleteMutex(MutexRef) {}
+	Audio::Mixer *getMixer() { return 0; }
+	void quit() {}
+	void displayMessageOnOSD(const char *) {}
+	void displayActivityIconOnOSD(const Graphics::Surface *) {}
+	void logMessage(LogMessageType::Type, const char *) {}
+};
+
+/**
+ * A video of 20 frames at 10 fps. Every pixel of a frame holds its frame
+ * number, and the palette changes on every fifth frame.
+ */
+class VideoDecoderTestDecoder : public Video::VideoDecoder {
+public:
+	class Track : public FixedRateVideoTrack {
+	public:
+		Track() : _curFrame(-1), _reversed(false), _dirtyPalette(false) {
+			_surface.create(4, 4, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_palette, 0, sizeof(_palette));
+		}
+
+		~Track() { _surface.free(); }
+
+		uint16 getWidth() const { return 4; }
+		uint16 getHeight() const { return 4; }
+		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+		int getCurFrame() const { return _curFrame; }
+		int getFrameCount() const { return 20; }
+		bool isSeekable() const { return true; }
+		bool canDecodeAhead() const { return true; }
+
+		bool seek(const Audio::Timestamp &time) {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		bool setReverse(bool reverse) {
+			_reversed = reverse;
+			return true;
+		}
+
+		bool isReversed() const { return _reversed; }
+
+		bool endOfTrack() const {
+			return _reversed ? _curFrame < 0 : FixedRateVideoTrack::endOfTrack();
+		}
+
+		const Graphics::Surface *decodeNextFrame() {
+			if (_reversed)
+				_curFrame--;
+			else
+				_curFrame++;
+
+			memset(_surface.getPixels(), _curFrame, 16);
+
+			if (_curFrame % 5 == 0) {
+				_palette[0] = _curFrame;
+				_dirtyPalette = true;
+			}
+
+			return &_surface;
+		}
+
+		const byte *getPalette() const {
+			_dirtyPalette = false;
+			return _palette;
+		}
+
+		bool hasDirtyPalette() const { return _dirtyPalette; }
+
+	protected:
+		Common::Rational getFrameRate() const { return 10; }
+
+	private:
+		Graphics::Surface _surface;
+		int _curFrame;
+		bool _reversed;
+		byte _palette[256 * 3];
+		mutable bool _dirtyPalette;
+	};
+
+	bool loadStream(Common::SeekableReadStream *) {
+		addTrack(new Track());
+		return true;
+	}
+};
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+	OSystem *_oldSystem;
+	VideoDecoderTestSystem *_system;
+
+	static int frameNumber(const Graphics::Surface *frame) {
+		return frame ? *(const byte *)frame->getPixels() : -1;
+	}
+
+	static void fillQueue(Video::VideoDecoder &decoder) {
+		while (decoder.decodeAhead())
+			;
+	}
+
+	public:
+	void setUp() {
+		_oldSystem = g_system;
+		_system = new VideoDecoderTestSystem();
+		g_system = _system;
+	}
+
+	void tearDown() {
+		g_system = _oldSystem;
+		delete _system;
+	}
+
+	void test_decode_ahead_matches_direct_decoding() {
+		VideoDecoderTestDecoder direct, ahead;
+		direct.loadStream(0);
+		ahead.loadStream(0);
+		TS_ASSERT(ahead.setDecodeAhead(3));
+
+		for (int i = 0; i < 20; i++) {
+			fillQueue(ahead);
+			TS_ASSERT_EQUALS(ahead.getCurFrame(), direct.getCurFrame());
+			TS_ASSERT_EQUALS(ahead.getTimeToNextFrame(), direct.getTimeToNextFrame());
+			TS_ASSERT(!ahead.endOfVideo());
+
+			const Graphics::Surface *directFrame = direct.decodeNextFrame();
+			const Graphics::Surface *aheadFrame = ahead.decodeNextFrame();
+			TS_ASSERT_EQUALS(frameNumber(aheadFrame), i);
+			TS_ASSERT_EQUALS(frameNumber(aheadFrame), frameNumber(directFrame));
+			TS_ASSERT_EQUALS(ahead.getCurFrame(), i);
+		}
+
+		TS_ASSERT(!ahead.decodeAhead());
+		TS_ASSERT(ahead.endOfVideo());
+		TS_ASSERT(direct.endOfVideo());
+	}
+
+	void test_decoding_ahead_keeps_frame_on_screen() {
+		VideoDecoderTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.setDecodeAhead(4);
+
+		const Graphics::Surface *frame = decoder.decodeNextFrame();
+		fillQueue(decoder);
+		TS_ASSERT_EQUALS(frameNumber(frame), 0);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 0);
+
+		// The queue is only resized while it is empty
+		TS_ASSERT(!decoder.setDecodeAhead(2));
+	}
+
+	void test_palette_changes() {
+		VideoDecoderTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.setDecodeAhead(8);
+
+		for (int i = 0; i < 12; i++) {
+			fillQueue(decoder);
+			decoder.decodeNextFrame();
+			fillQueue(decoder);
+
+			TS_ASSERT_EQUALS(decoder.hasDirtyPalette(), i % 5 == 0);
+			// The palette of the frame on screen, not of the frames queued
+			TS_ASSERT_EQUALS(decoder.getPalette()[0], i - i % 5);
+		}
+	}
+
+	void test_seek_drops_queue() {
+		VideoDecoderTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.setDecodeAhead(4);
+
+		decoder.decodeNextFrame();
+		fillQueue(decoder);
+
+		TS_ASSERT(decoder.seekToFrame(10));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 9);
+		fillQueue(decoder);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 9);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 10);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 11);
+	}
+
+	void test_rewind_drops_queue() {
+		VideoDecoderTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.setDecodeAhead(4);
+
+		for (int i = 0; i < 6; i++) {
+			decoder.decodeNextFrame();
+			fillQueue(decoder);
+		}
+
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), -1);
+		fillQueue(decoder);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 0);
+		TS_ASSERT_EQUALS(decoder.getPalette()[0], 0);
+	}
+
+	void test_reverse_returns_to_frame_on_screen() {
+		VideoDecoderTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.setDecodeAhead(4);
+
+		for (int i = 0; i < 6; i++) {
+			decoder.decodeNextFrame();
+			fillQueue(decoder);
+		}
+
+		TS_ASSERT(decoder.setReverse(true));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 5);
+
+		// Frames are not decoded ahead while playing backwards
+		TS_ASSERT(!decoder.decodeAhead());
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 4);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 3);
+
+		TS_ASSERT(decoder.setReverse(false));
+		fillQueue(decoder);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 4);
+	}
+
+	void test_end_time() {
+		VideoDecoderTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.setDecodeAhead(8);
+		decoder.setEndFrame(6);
+
+		// The end time only applies while playing
+		decoder.start();
+		fillQueue(decoder);
+
+		for (int i = 0; i <= 6; i++) {
+			TS_ASSERT(!decoder.endOfVideo());
+			TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), i);
+			fillQueue(decoder);
+		}
+
+		TS_ASSERT(decoder.endOfVideo());
+		TS_ASSERT(!decoder.decodeAhead());
+	}
+};
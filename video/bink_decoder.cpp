@@ -684,7 +684,15 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	if (readDCTCoeffs(*ctx.video, block, true) == 0) {
+		// Only the DC coefficient is set, so the whole block is one color
+		byte v = (block[0] + 0x7F) >> 8;
+
+		byte *dest = ctx.dest;
+		for (int i = 0; i < 16; i++, dest += ctx.pitch)
+			memset(dest, v, 16);
+		return;
+	}
 
 	IDCT(block);
 
@@ -829,9 +837,10 @@ void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
-
-	IDCTPut(ctx, block);
+	if (readDCTCoeffs(*ctx.video, block, true) == 0)
+		IDCTPutDC(ctx, block[0]);
+	else
+		IDCTPut(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
@@ -850,9 +859,10 @@ void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 
 	block[0] = getBundleValue(kSourceInterDC);
 
-	readDCTCoeffs(*ctx.video, block, false);
-
-	IDCTAdd(ctx, block);
+	if (readDCTCoeffs(*ctx.video, block, false) == 0)
+		IDCTAddDC(ctx, block[0]);
+	else
+		IDCTAdd(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
@@ -1080,8 +1090,8 @@ void BinkDecoder::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle, int
 	bundle.curDec = (byte *) dest;
 }
 
-/** Reads 8x8 block of DCT coefficients. */
-void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block, bool isIntra) {
+/** Reads 8x8 block of DCT coefficients, returns the number of AC coefficients read. */
+int BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block, bool isIntra) {
 	int coefCount = 0;
 	int coefIdx[64];
 
@@ -1177,6 +1187,7 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 		block[binkScan[idx]] = (block[binkScan[idx]] * quant[idx]) >> 11;
 	}
 
+	return coefCount;
 }
 
 /** Reads 8x8 block with residue after motion compensation. */
@@ -1354,6 +1365,28 @@ void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
 	}
 }
 
+// With only the DC coefficient set, both IDCT passes degenerate into
+// spreading MUNGE_ROW(dc) over the whole block.
+
+void BinkDecoder::BinkVideoTrack::IDCTPutDC(DecodeContext &ctx, int32 dc) {
+	byte v = MUNGE_ROW(dc);
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch)
+		memset(dest, v, 8);
+}
+
+void BinkDecoder::BinkVideoTrack::IDCTAddDC(DecodeContext &ctx, int32 dc) {
+	byte v = MUNGE_ROW(dc);
+	if (v == 0)
+		return;
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch)
+		for (int j = 0; j < 8; j++)
+			dest[j] += v;
+}
+
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
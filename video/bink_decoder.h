@@ -151,6 +151,7 @@ private:
 		int getCurFrame() const { return _curFrame; }
 		int getFrameCount() const { return _frameCount; }
 		const Graphics::Surface *decodeNextFrame() { return &_surface; }
+		bool canDecodeAhead() const { return true; }
 
 		/** Decode a video packet. */
 		void decodePacket(VideoFrame &frame);
@@ -315,13 +316,16 @@ private:
 		void readPatterns    (VideoFrame &video, Bundle &bundle);
 		void readColors      (VideoFrame &video, Bundle &bundle);
 		void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
-		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
+		int  readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
 		// Bink video IDCT
 		void IDCT(int32 *block);
 		void IDCTPut(DecodeContext &ctx, int32 *block);
 		void IDCTAdd(DecodeContext &ctx, int32 *block);
+		/** Fast paths for blocks where only the DC coefficient is set. */
+		void IDCTPutDC(DecodeContext &ctx, int32 dc);
+		void IDCTAddDC(DecodeContext &ctx, int32 dc);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -142,6 +142,7 @@ private:
 		bool isReversed() const { return _reversed; }
 		bool canDither() const;
 		void setDither(const byte *palette);
+		bool canDecodeAhead() const { return true; }
 
 		Common::Rational getScaledWidth() const;
 		Common::Rational getScaledHeight() const;
@@ -90,6 +90,7 @@ protected:
 		const Graphics::Surface *decodeNextFrame() { return _surface; }
 		const byte *getPalette() const { _dirtyPalette = false; return _palette; }
 		bool hasDirtyPalette() const { return _dirtyPalette; }
+		bool canDecodeAhead() const { return true; }
 
 		void readTrees(Common::BitStreamMemory8LSB &bs, uint32 mMapSize, uint32 mClrSize, uint32 fullSize, uint32 typeSize);
 		void increaseCurFrame() { _curFrame++; }
@@ -27,9 +27,11 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
@@ -49,6 +51,8 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_decodedAheadStart = 0;
+	_decodedAheadCount = 0;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -57,6 +61,10 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	freeDecodedAhead();
+}
+
 void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
@@ -80,6 +88,7 @@ void VideoDecoder::close() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	freeDecodedAhead();
 }
 
 bool VideoDecoder::loadFile(const Common::String &filename) {
@@ -185,6 +194,25 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	// With decoding ahead enabled, always hand out a queued copy, so that
+	// a later decodeAhead() call cannot overwrite the frame on screen.
+	if (_decodedAheadCount == 0)
+		decodeAhead();
+
+	if (_decodedAheadCount != 0) {
+		DecodedFrame &decoded = _decodedAhead[_decodedAheadStart];
+		_decodedAheadStart = (_decodedAheadStart + 1) % _decodedAhead.size();
+		_decodedAheadCount--;
+
+		if (decoded.dirtyPalette) {
+			memcpy(_decodedAheadPalette, decoded.palette, sizeof(_decodedAheadPalette));
+			_palette = _decodedAheadPalette;
+			_dirtyPalette = true;
+		}
+
+		return decoded.hasFrame ? decoded.surface : 0;
+	}
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -205,11 +233,85 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool VideoDecoder::setDecodeAhead(uint frames) {
+	if (_decodedAheadCount != 0)
+		return false;
+
+	freeDecodedAhead();
+
+	if (frames != 0)
+		_decodedAhead.resize(frames + 1);
+
+	return true;
+}
+
+bool VideoDecoder::decodeAhead() {
+	if (_decodedAheadCount + 1 >= _decodedAhead.size())
+		return false;
+
+	VideoTrack *track = findDecodeAheadTrack();
+
+	if (!track || track->isReversed() || track->endOfTrack())
+		return false;
+
+	uint32 nextFrameStartTime = track->getNextFrameStartTime();
+
+	if (_endTimeSet && nextFrameStartTime >= (uint)_endTime.msecs())
+		return false;
+
+	// The palette of the frame on screen may belong to the track, which is
+	// about to overwrite it
+	if (_palette && _palette != _decodedAheadPalette) {
+		memcpy(_decodedAheadPalette, _palette, sizeof(_decodedAheadPalette));
+		_palette = _decodedAheadPalette;
+	}
+
+	DecodedFrame &decoded = _decodedAhead[(_decodedAheadStart + _decodedAheadCount) % _decodedAhead.size()];
+	decoded.curFrame = track->getCurFrame();
+	decoded.nextFrameStartTime = nextFrameStartTime;
+
+	_canSetDither = false;
+	readNextPacket();
+
+	const Graphics::Surface *frame = track->decodeNextFrame();
+	decoded.hasFrame = (frame != 0);
+
+	if (frame) {
+		if (!decoded.surface)
+			decoded.surface = new Graphics::Surface();
+
+		if (decoded.surface->w != frame->w || decoded.surface->h != frame->h || decoded.surface->format != frame->format) {
+			decoded.surface->free();
+			decoded.surface->create(frame->w, frame->h, frame->format);
+		}
+
+		decoded.surface->copyRectToSurface(*frame, 0, 0, Common::Rect(frame->w, frame->h));
+	}
+
+	decoded.dirtyPalette = track->hasDirtyPalette();
+
+	if (decoded.dirtyPalette)
+		memcpy(decoded.palette, track->getPalette(), sizeof(decoded.palette));
+
+	_decodedAheadCount++;
+	findNextVideoTrack();
+	return true;
+}
+
 bool VideoDecoder::setReverse(bool reverse) {
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
 		return false;
 
+	// Frames decoded ahead were decoded forward, so put the track back to
+	// the frame on screen before turning around
+	if (reverse && _decodedAheadCount != 0) {
+		Audio::Timestamp time = findDecodeAheadTrack()->getFrameTime(getCurFrame() + 1);
+
+		if (time < 0 || !seek(time))
+			return false;
+	}
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -230,6 +332,9 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (_decodedAheadCount != 0)
+		return _decodedAhead[_decodedAheadStart].curFrame;
+
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -271,13 +376,25 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
+	uint32 nextFrameStartTime;
+	bool isReversed = false;
+
+	if (_decodedAheadCount != 0) {
+		// Frames decoded ahead are always played forward
+		nextFrameStartTime = _decodedAhead[_decodedAheadStart].nextFrameStartTime;
+	} else if (_nextVideoTrack) {
+		nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+		isReversed = _nextVideoTrack->isReversed();
+	} else {
+		return 0;
+	}
+
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (isReversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -296,8 +413,12 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool endReached;
+		if (track->getTrackType() == Track::kTrackTypeVideo)
+			endReached = isVideoTrackFinished((const VideoTrack *)track);
+		else
+			endReached = track->endOfTrack();
+
 		if (!endReached)
 			return false;
 	}
@@ -324,6 +445,8 @@ bool VideoDecoder::rewind() {
 	if (isPlaying())
 		stopAudio();
 
+	dropDecodedAhead();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->rewind())
 			return false;
@@ -358,6 +481,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (isPlaying())
 		stopAudio();
 
+	dropDecodedAhead();
+
 	// Do the actual seeking
 	if (!seekIntern(time))
 		return false;
@@ -860,6 +985,9 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 }
 
 bool VideoDecoder::endOfVideoTracks() const {
+	if (_decodedAheadCount != 0)
+		return false;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack())
 			return false;
@@ -919,11 +1047,7 @@ bool VideoDecoder::hasFramesLeft() const {
 		if ((*it)->getTrackType() != Track::kTrackTypeVideo)
 			continue;
 
-		const VideoTrack *track = (const VideoTrack *)*it;
-
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
-		if (!endReached)
+		if (!isVideoTrackFinished((const VideoTrack *)*it))
 			return true;
 	}
 
@@ -938,6 +1062,53 @@ bool VideoDecoder::hasAudio() const {
 	return false;
 }
 
+bool VideoDecoder::isVideoTrackFinished(const VideoTrack *track) const {
+	// A track which ran ahead still has its queued frames to show
+	uint32 nextFrameStartTime;
+	if (_decodedAheadCount != 0)
+		nextFrameStartTime = _decodedAhead[_decodedAheadStart].nextFrameStartTime;
+	else if (track->endOfTrack())
+		return true;
+	else
+		nextFrameStartTime = track->getNextFrameStartTime();
+
+	return isPlaying() && _endTimeSet && nextFrameStartTime >= (uint)_endTime.msecs();
+}
+
+VideoDecoder::VideoTrack *VideoDecoder::findDecodeAheadTrack() const {
+	VideoTrack *track = 0;
+
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			// Queued frames are only tracked for a single video track
+			if (track)
+				return 0;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	return (track && track->canDecodeAhead()) ? track : 0;
+}
+
+void VideoDecoder::dropDecodedAhead() {
+	// The surfaces are kept for the frames decoded after the seek
+	_decodedAheadStart = 0;
+	_decodedAheadCount = 0;
+}
+
+void VideoDecoder::freeDecodedAhead() {
+	for (uint i = 0; i < _decodedAhead.size(); i++) {
+		if (_decodedAhead[i].surface) {
+			_decodedAhead[i].surface->free();
+			delete _decodedAhead[i].surface;
+		}
+	}
+
+	_decodedAhead.clear();
+	dropDecodedAhead();
+}
+
 void VideoDecoder::eraseTrack(Track *track) {
 	for (uint idx = 0; idx < _externalTracks.size(); ++idx) {
 		if (_externalTracks[idx] == track)
@@ -52,7 +52,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -355,6 +355,36 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Allow up to the given number of frames to be decoded before they are
+	 * due, using decodeAhead(). 0, the default, disables decoding ahead.
+	 *
+	 * While this is enabled, decodeNextFrame() hands out copies of the
+	 * frames, which stay valid until the next decodeNextFrame() call even
+	 * if decodeAhead() is called in between.
+	 *
+	 * This only has an effect on videos with a single video track which
+	 * supports it. This setting remains until close() is called (which may
+	 * be called from loadStream()).
+	 *
+	 * @param frames The maximum number of frames to keep decoded
+	 * @return true on success, false if frames are still queued
+	 */
+	bool setDecodeAhead(uint frames);
+
+	/**
+	 * Decode one frame before it is due and queue it for decodeNextFrame().
+	 *
+	 * Playback loops can call this when they would otherwise sleep until
+	 * needsUpdate() returns true, so the time spent decoding is taken from
+	 * the idle time between frames instead of delaying the next one.
+	 * Queued frames are dropped on seeking and rewinding.
+	 *
+	 * @return true if a frame was decoded, false if the queue is full or
+	 *         no frame can be decoded ahead
+	 */
+	bool decodeAhead();
+
 	/**
 	 * Set the default high color format for videos that convert from YUV.
 	 *
@@ -645,6 +675,17 @@ protected:
 		 * Activate dithering mode with a palette
 		 */
 		virtual void setDither(const byte *palette) {}
+
+		/**
+		 * Can frames of this track be decoded before they are due?
+		 *
+		 * This requires that the returned surface and the palette are the
+		 * only state of the track that callers look at after a frame has
+		 * been decoded.
+		 *
+		 * @see VideoDecoder::decodeAhead()
+		 */
+		virtual bool canDecodeAhead() const { return false; }
 	};
 
 	/**
@@ -949,12 +990,34 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// A frame decoded by decodeAhead() and the playback state it was decoded in
+	struct DecodedFrame {
+		DecodedFrame() : surface(0), hasFrame(false), dirtyPalette(false), curFrame(-1), nextFrameStartTime(0) {}
+
+		Graphics::Surface *surface;
+		bool hasFrame;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+		int curFrame;
+		uint32 nextFrameStartTime;
+	};
+
+	// Ring of decoded frames, with one more slot than may be queued so the
+	// frame handed out last is never overwritten by decodeAhead()
+	Common::Array<DecodedFrame> _decodedAhead;
+	uint _decodedAheadStart, _decodedAheadCount;
+	byte _decodedAheadPalette[256 * 3];
+
 	// Internal helper functions
 	void stopAudio();
 	void startAudio();
 	void startAudioLimit(const Audio::Timestamp &limit);
 	bool hasFramesLeft() const;
 	bool hasAudio() const;
+	bool isVideoTrackFinished(const VideoTrack *track) const;
+	VideoTrack *findDecodeAheadTrack() const;
+	void dropDecodedAhead();
+	void freeDecodedAhead();
 
 	int32 _startTime;
 	uint32 _pauseLevel;